@@ -21,7 +21,11 @@ public:
         this->screenHeight_ = appContext->renderHeight;
     }
     
+    // handleEvent and simulate run on the simulation thread, at a fixed rate
+    // and with AppContext::stateMutex held. Anything render() needs from them
+    // has to be handed over through a snapshot (see TripleBuffer).
     virtual void handleEvent(const TimedInputEvent& e) {}
+    virtual void simulate(double timeSeconds, float deltaTime) {}
     
     virtual void update(float deltaTime) {}
     virtual void render() {}
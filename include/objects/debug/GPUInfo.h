@@ -0,0 +1,22 @@
+#ifndef GPU_INFO_H
+#define GPU_INFO_H
+
+#include <string>
+#include <objects/debug/FPSCounter.h>
+#include "system/TextRenderer.h"
+#include "system/Renderer2D.h"
+
+class GPUInfo : public FPSCounter {
+public:
+    GPUInfo(TextRenderer* textRenderer, const std::string& fontPath, int fontSize, float yPos);
+    ~GPUInfo() = default;
+
+    void update() override;
+    void render(Renderer2D* renderer) override;
+
+private:
+    double refreshAccumulator_ = 0.0;
+    double lastUpdateTime_ = 0.0;
+};
+
+#endif
@@ -6,6 +6,15 @@
 #include <system/Renderer2D.h>
 #include <system/InputQueue.h>
 #include <system/TextRenderer.h>
+#include <system/TextureLoader.h>
+#include <system/CachedLayer.h>
+#include <system/PostProcess.h>
+#include <utils/TripleBuffer.h>
+
+// What render() needs from the simulation thread.
+struct MainMenuSnapshot {
+    int hoveredIndex = -1;
+};
 
 struct MenuButton {
     TextObject* text = nullptr;
@@ -25,8 +34,13 @@ public:
 private:
     std::vector<MenuButton> buttons_;
     int hoveredIndex_ = -1;
-    GLuint backgroundTexture_ = 0;
+    int renderedHoverIndex_ = -1;
+    TripleBuffer<MainMenuSnapshot> snapshots_;
+    TextureHandle backgroundTexture_;
+    CachedLayer* layer_ = nullptr;
+    CachedBlur* backgroundBlur_ = nullptr;
 
+    void renderLayer();
     void createButton(const std::string& label, int targetState, float y);
     void updateHover(float x, float y);
     void activateButton(int index);
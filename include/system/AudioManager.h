@@ -12,6 +12,31 @@ enum class AudioType {
     STREAM
 };
 
+// What the manager did to a channel at a point on the timeline clock, with
+// volumes already multiplied down to the final channel volume. Recorded so
+// an offline render can mix the same audio without a device.
+struct AudioTimelineEvent {
+    enum Type {
+        PLAY,
+        STOP,
+        PAUSE,
+        RESUME,
+        SEEK,
+        VOLUME
+    };
+
+    Type type;
+    double timeSeconds = 0.0;
+    std::string name;
+    std::string path;
+    float volume = 1.0f;
+    bool loop = false;
+    bool isSample = false;
+
+    // Stream position for SEEK.
+    double position = 0.0;
+};
+
 struct AudioHandle {
     HSTREAM stream = 0;
     HSAMPLE sample = 0;
@@ -72,6 +97,12 @@ public:
     
     void update(float deltaTime);
     
+    // Records every play, stop and volume change from here on, stamped with
+    // the time last passed to setTimelineTime().
+    void beginTimeline();
+    void setTimelineTime(double seconds) { timelineTime_ = seconds; }
+    std::vector<AudioTimelineEvent> endTimeline();
+    
 private:
     AudioManager() = default;
     ~AudioManager() { shutdown(); }
@@ -80,6 +111,8 @@ private:
     
     void updateFade(float deltaTime);
     void applyVolumes();
+    void recordTimeline(AudioTimelineEvent::Type type, const std::string& name, const AudioHandle& handle,
+                        float volume = 1.0f, double position = 0.0);
     
     std::map<std::string, AudioHandle> audioHandles_;
     std::string currentMusic_;
@@ -98,6 +131,11 @@ private:
     bool isCrossfading_ = false;
     std::string crossfadeTarget_;
     
+    bool recordingTimeline_ = false;
+    double timelineTime_ = 0.0;
+    std::vector<AudioTimelineEvent> timeline_;
+    std::map<std::string, float> recordedVolumes_;
+    
     bool initialized_ = false;
 };
 
@@ -0,0 +1,20 @@
+#ifndef AUDIO_MIXDOWN_H
+#define AUDIO_MIXDOWN_H
+
+#include <string>
+#include <vector>
+
+#include "system/AudioManager.h"
+
+namespace AudioMixdown {
+    // Replays a timeline recorded by AudioManager through BASS decoding
+    // channels and writes the mix as a 32-bit float stereo WAV file of
+    // exactly durationSeconds. Needs BASS initialized, but no output device
+    // (device 0 works). The same timeline always produces the same file.
+    // Fails without writing anything if the mix would not fit the 4 GiB
+    // WAV limit (about 3.4 hours at 44.1 kHz).
+    bool render(const std::vector<AudioTimelineEvent>& events, double durationSeconds, const std::string& wavPath,
+                int sampleRate = 44100);
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef CACHED_LAYER_H
+#define CACHED_LAYER_H
+
+#include "system/Variables.h"
+#include "system/Renderer2D.h"
+
+// A group of draws rendered once into its own RenderContext and composited
+// as a single quad on later frames, until invalidate() is called.
+//
+//     if (layer.begin()) {
+//         ...draw...
+//         layer.end();
+//     }
+//     layer.composite();
+class CachedLayer {
+public:
+    CachedLayer(AppContext* appContext);
+    ~CachedLayer();
+
+    CachedLayer(const CachedLayer&) = delete;
+    CachedLayer& operator=(const CachedLayer&) = delete;
+
+    // Returns true when the layer has to be redrawn; the layer's framebuffer
+    // is then bound and cleared until end() is called.
+    bool begin();
+    void end();
+
+    void composite(const Color& tint = Color(1.0f, 1.0f, 1.0f, 1.0f));
+
+    void invalidate() { valid_ = false; }
+    bool isValid() const { return valid_; }
+
+private:
+    bool ensureTarget();
+    void release();
+
+    AppContext* appContext_ = nullptr;
+    RenderContext* target_ = nullptr;
+    GLuint previousFramebuffer_ = 0;
+    GLint previousViewport_[4] = {};
+    bool valid_ = false;
+    bool recording_ = false;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include <vector>
+
+struct DynamicResolutionConfig {
+    double targetFrameMs = 1000.0 / 60.0;
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+
+    // Scales are snapped to this step so the render target pool keeps
+    // hitting the same few sizes.
+    float scaleStep = 0.05f;
+
+    // Frames averaged per decision; also the minimum time between changes.
+    int sampleFrames = 30;
+
+    // Only scale back up once frames come in this far under the target.
+    double upscaleHeadroom = 0.8;
+};
+
+// Picks the offscreen render scale from recent frame costs. The logical
+// render size (and every coordinate in it) never changes; only the size of
+// the target it is rasterized into does, and the final blit upscales.
+class DynamicResolution {
+public:
+    DynamicResolution(const DynamicResolutionConfig& config = DynamicResolutionConfig());
+
+    void setConfig(const DynamicResolutionConfig& config);
+    const DynamicResolutionConfig& getConfig() const { return config_; }
+
+    // Feed the CPU and GPU time of one frame (either may be 0 when unknown).
+    // Returns true when getScale() changed.
+    bool update(double cpuMs, double gpuMs);
+
+    float getScale() const { return scale_; }
+    double getAverageFrameMs() const { return averageMs_; }
+
+private:
+    float snap(float scale) const;
+
+    DynamicResolutionConfig config_;
+    std::vector<double> samples_;
+    size_t sampleIndex_ = 0;
+    int framesSinceChange_ = 0;
+    float scale_ = 1.0f;
+    double averageMs_ = 0.0;
+};
+
+#endif
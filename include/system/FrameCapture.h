@@ -0,0 +1,20 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <string>
+#include <vector>
+
+#include "system/Variables.h"
+
+namespace FrameCapture {
+    // Reads the target's color buffer back as tightly packed RGBA rows,
+    // top row first. Blocks until the GPU has finished the frame.
+    bool readPixels(const RenderContext* target, std::vector<unsigned char>& pixels);
+
+    bool writePNG(const std::string& path, const unsigned char* rgba, int width, int height);
+    // QOI encodes several times faster than PNG at a somewhat larger size.
+    bool writeQOI(const std::string& path, const unsigned char* rgba, int width, int height);
+    bool savePNG(const RenderContext* target, const std::string& path);
+}
+
+#endif
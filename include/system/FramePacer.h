@@ -0,0 +1,64 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+#include <vector>
+
+#define FRAME_PACER_HISTORY 240
+
+// Holds the main loop to a frame rate cap on a steady clock. Waits sleep
+// while there is plenty of time left and spin for the last stretch, since
+// sleep wakeups are only accurate to the OS timer slack.
+//
+// Normal mode waits at the end of the frame, after the swap. Late sampling
+// mode waits at the start instead, until just before the next slot minus
+// the expected frame cost, so input is polled as late as possible.
+class FramePacer {
+public:
+    FramePacer(int framerateCap = -1);
+
+    // <= 0 disables the cap.
+    void setFramerateCap(int framerateCap);
+    int getFramerateCap() const { return framerateCap_; }
+
+    void setLateSampling(bool enabled) { lateSampling_ = enabled; }
+    bool isLateSampling() const { return lateSampling_; }
+
+    // Call before polling input and after presenting, respectively.
+    void beginFrame();
+    void endFrame();
+
+    // Standard deviation and worst deviation of the frame interval from
+    // the target over the last FRAME_PACER_HISTORY frames.
+    double getJitterMs() const { return jitterMs_; }
+    double getMaxDeviationMs() const { return maxDeviationMs_; }
+    double getAverageIntervalMs() const { return averageIntervalMs_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void waitUntil(Clock::time_point deadline);
+    void recordInterval(Clock::time_point frameStart);
+
+    int framerateCap_ = -1;
+    Clock::duration period_ = Clock::duration::zero();
+    bool lateSampling_ = false;
+
+    Clock::time_point nextSlot_;
+    Clock::time_point frameStart_;
+    Clock::time_point lastFrameStart_;
+    bool started_ = false;
+
+    // Exponential moving averages, in milliseconds. The overshoot starts
+    // small so the first waits sleep and measure the real value.
+    double workMs_ = 0.0;
+    double sleepOvershootMs_ = 0.1;
+
+    std::vector<double> intervals_;
+    size_t intervalIndex_ = 0;
+    double jitterMs_ = 0.0;
+    double maxDeviationMs_ = 0.0;
+    double averageIntervalMs_ = 0.0;
+};
+
+#endif
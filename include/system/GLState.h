@@ -0,0 +1,73 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <string>
+#include <unordered_map>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#define GL_STATE_MAX_TEXTURE_UNITS 16
+#define GL_STATE_PROJECTION_BINDING 0
+
+// Shadow copy of the GL bindings the renderers touch. Every bind goes through
+// here so a call that would not change anything never reaches the driver.
+// Anything that binds behind its back must call invalidate() afterwards.
+class GLState {
+public:
+    static GLState& getInstance() {
+        static GLState instance;
+        return instance;
+    }
+
+    bool initialize();
+    void shutdown();
+    void invalidate();
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    void bindBuffer(GLenum target, GLuint buffer);
+    void bindTexture(GLuint unit, GLuint texture);
+    // For binding non-2D targets (buffer textures) by hand.
+    void setActiveUnit(GLuint unit);
+    void bindFramebuffer(GLuint framebuffer);
+
+    void deleteProgram(GLuint program);
+    void deleteVertexArray(GLuint vao);
+    void deleteBuffer(GLuint buffer);
+    void deleteTexture(GLuint texture);
+    void deleteFramebuffer(GLuint framebuffer);
+
+    // Resolved once per program, then served from the cache.
+    GLint getUniformLocation(GLuint program, const std::string& name);
+
+    // Binds the program's "Projection" uniform block to the shared buffer.
+    void attachProjectionBlock(GLuint program);
+    void setProjection(const glm::mat4& projection);
+    const glm::mat4& getProjection() const { return projection_; }
+
+    // Asks the driver while the binding is unknown (after invalidate()),
+    // so callers can always restore what they get back.
+    GLuint getBoundFramebuffer();
+
+private:
+    GLState() = default;
+    ~GLState() = default;
+    GLState(const GLState&) = delete;
+    GLState& operator=(const GLState&) = delete;
+
+    GLuint program_ = 0;
+    GLuint vao_ = 0;
+    GLuint arrayBuffer_ = 0;
+    GLuint uniformBuffer_ = 0;
+    GLuint activeUnit_ = 0;
+    GLuint textures_[GL_STATE_MAX_TEXTURE_UNITS] = {};
+    GLuint framebuffer_ = 0;
+
+    GLuint projectionUBO_ = 0;
+    glm::mat4 projection_ = glm::mat4(1.0f);
+    bool projectionValid_ = false;
+
+    std::unordered_map<GLuint, std::unordered_map<std::string, GLint>> uniformLocations_;
+};
+
+#endif
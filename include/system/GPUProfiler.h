@@ -0,0 +1,91 @@
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+
+#define GPU_PROFILER_FRAME_LATENCY 4
+
+struct GPUScopeResult {
+    std::string name;
+    int depth = 0;
+    double milliseconds = 0.0;
+};
+
+// Times render passes on the GPU with timestamp queries. Results are read
+// back GPU_PROFILER_FRAME_LATENCY frames later and only when they are
+// already available, so the CPU never waits on the GPU.
+class GPUProfiler {
+public:
+    GPUProfiler() = default;
+    ~GPUProfiler();
+
+    GPUProfiler(const GPUProfiler&) = delete;
+    GPUProfiler& operator=(const GPUProfiler&) = delete;
+
+    bool initialize();
+    void shutdown();
+
+    bool isSupported() const { return supported_; }
+
+    void beginFrame();
+    void endFrame();
+
+    // Scopes nest; each one is shown indented under its parent.
+    void beginScope(const std::string& name);
+    void endScope();
+
+    const std::vector<GPUScopeResult>& getResults() const { return results_; }
+    double getFrameMilliseconds() const { return frameMilliseconds_; }
+    int getDroppedFrames() const { return droppedFrames_; }
+
+private:
+    struct Scope {
+        std::string name;
+        int depth;
+        GLuint startQuery;
+        GLuint endQuery;
+    };
+
+    struct Frame {
+        std::vector<Scope> scopes;
+        std::vector<GLuint> queries;
+        size_t usedQueries = 0;
+        GLuint frameStart = 0;
+        GLuint frameEnd = 0;
+        bool pending = false;
+    };
+
+    GLuint nextQuery(Frame& frame);
+    void collect(Frame& frame);
+
+    bool supported_ = false;
+    bool inFrame_ = false;
+
+    Frame frames_[GPU_PROFILER_FRAME_LATENCY];
+    int frameIndex_ = 0;
+    std::vector<size_t> openScopes_;
+
+    std::vector<GPUScopeResult> results_;
+    double frameMilliseconds_ = 0.0;
+    int droppedFrames_ = 0;
+};
+
+class GPUProfileScope {
+public:
+    GPUProfileScope(GPUProfiler* profiler, const std::string& name) : profiler_(profiler) {
+        if (profiler_) profiler_->beginScope(name);
+    }
+    ~GPUProfileScope() {
+        if (profiler_) profiler_->endScope();
+    }
+
+    GPUProfileScope(const GPUProfileScope&) = delete;
+    GPUProfileScope& operator=(const GPUProfileScope&) = delete;
+
+private:
+    GPUProfiler* profiler_;
+};
+
+#endif
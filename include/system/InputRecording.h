@@ -0,0 +1,34 @@
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "system/InputQueue.h"
+
+// Input events of one session with their timeSeconds, saved as text so a
+// replay feeds the simulation exactly the same events at exactly the same
+// ticks. Times are written with full precision.
+class InputRecording {
+public:
+    // Thread-safe; called by the simulation thread for every event it handles.
+    void record(const TimedInputEvent& event);
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    // Playback: returns the next event with timeSeconds <= untilSeconds.
+    bool next(double untilSeconds, TimedInputEvent& event);
+    void rewind() { cursor_ = 0; }
+
+    size_t size() const;
+    double getDuration() const;
+
+private:
+    std::vector<TimedInputEvent> events_;
+    size_t cursor_ = 0;
+    mutable std::mutex mutex_;
+};
+
+#endif
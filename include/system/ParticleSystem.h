@@ -0,0 +1,78 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include <random>
+#include <vector>
+
+#include "system/Renderer2D.h"
+
+struct ParticleEmitterConfig {
+    // Launch direction in radians, 0 pointing right, growing clockwise on
+    // screen (y down).
+    float angleMin = 0.0f;
+    float angleMax = 6.2831853f;
+    float speedMin = 50.0f;
+    float speedMax = 150.0f;
+
+    float lifeMin = 0.5f;
+    float lifeMax = 1.0f;
+
+    float sizeStart = 8.0f;
+    float sizeEnd = 0.0f;
+
+    Color color = Color(1.0f, 1.0f, 1.0f, 1.0f);
+
+    // Alpha goes to zero over the particle's life.
+    bool fadeOut = true;
+};
+
+// Particles stored as separate arrays per attribute, so the update runs as
+// straight SIMD loops over contiguous floats. Dead particles are replaced by
+// the last live one, keeping the live range packed. Purely visual: update
+// and render both run on the render thread.
+class ParticleSystem {
+public:
+    ParticleSystem(size_t capacity = 65536);
+
+    void setTexture(const TextureRegion& region) { region_ = region; }
+    void setTexture(GLuint textureID);
+    void setGravity(float x, float y) { gravityX_ = x; gravityY_ = y; }
+
+    // Fraction of velocity lost per second.
+    void setDrag(float drag) { drag_ = drag; }
+
+    // Returns how many were emitted; stops at capacity.
+    size_t emit(float x, float y, size_t count, const ParticleEmitterConfig& config);
+
+    void update(float deltaTime);
+
+    // Writes every live particle straight into Renderer2D's batch.
+    void render(Renderer2D* renderer) const;
+
+    void clear() { count_ = 0; }
+    size_t getCount() const { return count_; }
+    size_t getCapacity() const { return capacity_; }
+
+private:
+    void integrate(float deltaTime);
+    void removeDead();
+
+    size_t capacity_;
+    size_t count_ = 0;
+
+    std::vector<float> x_, y_;
+    std::vector<float> vx_, vy_;
+    std::vector<float> life_, invLifetime_;
+    std::vector<float> sizeStart_, sizeEnd_;
+    std::vector<float> r_, g_, b_, a_;
+    std::vector<unsigned char> fade_;
+
+    TextureRegion region_;
+    float gravityX_ = 0.0f;
+    float gravityY_ = 0.0f;
+    float drag_ = 0.0f;
+
+    std::mt19937 rng_;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef PLOT_BUFFER_H
+#define PLOT_BUFFER_H
+
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "system/Renderer2D.h"
+
+// Points of a graph kept in GPU memory (a buffer texture of vec2), for data
+// that is drawn every frame but rarely changes: results graphs, waveform
+// previews. Draw it with Renderer2D::drawPlot. GL thread only.
+class PlotBuffer {
+public:
+    PlotBuffer() = default;
+    ~PlotBuffer();
+
+    PlotBuffer(const PlotBuffer&) = delete;
+    PlotBuffer& operator=(const PlotBuffer&) = delete;
+
+    void setPoints(const glm::vec2* points, size_t count);
+    void setPoints(const std::vector<glm::vec2>& points);
+
+    // Evenly spaced samples; point i is (i, values[i]).
+    void setValues(const float* values, size_t count);
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    // Bounding box of the points, y up (y is the minimum).
+    const Rect& getBounds() const { return bounds_; }
+
+    GLuint getTexture() const { return texture_; }
+
+private:
+    void upload(const glm::vec2* points, size_t count);
+
+    GLuint buffer_ = 0;
+    GLuint texture_ = 0;
+    size_t count_ = 0;
+    size_t capacity_ = 0;
+    Rect bounds_ = { 0.0f, 0.0f, 0.0f, 0.0f };
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef POST_PROCESS_H
+#define POST_PROCESS_H
+
+#include <glad/glad.h>
+
+#include "system/Variables.h"
+
+class RenderTargetPool;
+
+// Fullscreen passes between pooled RenderContexts. Every pass draws one
+// triangle that covers the target, sampling "source" at TexCoord; the
+// texture's orientation is carried through unchanged, so a result can be
+// drawn with the same uv rect as its source.
+class PostProcess {
+public:
+    PostProcess(RenderTargetPool* pool);
+    ~PostProcess();
+
+    PostProcess(const PostProcess&) = delete;
+    PostProcess& operator=(const PostProcess&) = delete;
+
+    bool initialize();
+    void shutdown();
+
+    // Links a fragment shader with the shared fullscreen vertex shader,
+    // through the shader cache. It receives "in vec2 TexCoord",
+    // "uniform sampler2D source" and "uniform vec2 texelSize" (of the
+    // source).
+    GLuint createEffect(const char* fragmentSource);
+    void destroyEffect(GLuint effect);
+
+    // Runs one pass into a target acquired from the pool; release it there.
+    // Flush Renderer2D first, the passes switch framebuffers.
+    RenderContext* apply(GLuint effect, GLuint sourceTexture, int sourceWidth, int sourceHeight,
+                         int targetWidth, int targetHeight);
+
+    // Dual-Kawase blur: each iteration halves the resolution on the way
+    // down and doubles it on the way up, so the cost stays around that of
+    // a couple of full-resolution passes whatever the radius. The result
+    // is at half the source resolution.
+    RenderContext* blur(GLuint sourceTexture, int width, int height, int iterations, float offset = 1.0f);
+
+    RenderTargetPool* getPool() const { return pool_; }
+
+private:
+    void runPass(GLuint program, GLuint sourceTexture, int sourceWidth, int sourceHeight,
+                 RenderContext* target, float offset);
+
+    RenderTargetPool* pool_;
+    GLuint emptyVAO_ = 0;
+    GLuint downsampleProgram_ = 0;
+    GLuint upsampleProgram_ = 0;
+};
+
+// A blurred copy of one texture that is only recomputed when the source
+// texture, its size or the blur settings change.
+class CachedBlur {
+public:
+    CachedBlur(AppContext* appContext, int iterations = 4, float offset = 1.0f);
+    ~CachedBlur();
+
+    CachedBlur(const CachedBlur&) = delete;
+    CachedBlur& operator=(const CachedBlur&) = delete;
+
+    // Returns the blurred texture, or 0 if the blur could not be made.
+    GLuint get(GLuint sourceTexture, int width, int height);
+
+    void setIterations(int iterations);
+    void invalidate();
+
+private:
+    AppContext* appContext_;
+    int iterations_;
+    float offset_;
+
+    RenderContext* result_ = nullptr;
+    GLuint sourceTexture_ = 0;
+    int sourceWidth_ = 0;
+    int sourceHeight_ = 0;
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <glad/glad.h>
+
+#include "system/Renderer2D.h"
+
+enum class RenderCommandType : uint8_t {
+    RECT,
+    LINE,
+    CIRCLE,
+    TEXTURE
+};
+
+// Sort key, most significant first:
+//   layer (8) | depth (16) | shader (4) | texture (20) | unused (16)
+// Layer, then depth, order overlapping commands. Only commands on the same
+// layer and depth are reordered by shader and texture for batching, so
+// give anything whose overlap order matters its own layer or depth.
+struct RenderCommand {
+    uint64_t sortKey;
+    RenderCommandType type;
+    GLuint textureID;
+    float x, y, width, height;
+    float u0, v0, u1, v1;
+    Color color;
+    float param;
+};
+
+uint64_t makeRenderSortKey(uint8_t layer, uint8_t shader, GLuint textureID, float depth);
+
+// Recorded by one thread without locking, then handed to a RenderQueue.
+class RenderCommandBuffer {
+public:
+    void drawRect(uint8_t layer, float depth, float x, float y, float width, float height, const Color& color);
+    void drawLine(uint8_t layer, float depth, float x1, float y1, float x2, float y2, float thickness, const Color& color);
+    void drawCircle(uint8_t layer, float depth, float x, float y, float radius, const Color& color);
+    void drawTexture(uint8_t layer, float depth, GLuint textureID, float x, float y, float width, float height,
+                     const Color& tint = Color(1.0f, 1.0f, 1.0f, 1.0f));
+    void drawTexture(uint8_t layer, float depth, const TextureRegion& region, float x, float y, float width, float height,
+                     const Color& tint = Color(1.0f, 1.0f, 1.0f, 1.0f));
+
+    void reserve(size_t count) { commands_.reserve(count); }
+    void clear() { commands_.clear(); }
+    size_t size() const { return commands_.size(); }
+    bool empty() const { return commands_.empty(); }
+
+    const std::vector<RenderCommand>& getCommands() const { return commands_; }
+
+private:
+    std::vector<RenderCommand> commands_;
+};
+
+// Collects command buffers from any thread and replays them, sorted, on the
+// GL thread through Renderer2D's batcher.
+//
+// The main loop executes the queue after BaseState::render(), so queued
+// commands land on top of everything the state drew directly, whatever
+// their layer. A state that needs immediate drawing above queued commands
+// calls execute() itself from render(), before drawing it.
+class RenderQueue {
+public:
+    void submit(RenderCommandBuffer& buffer);
+    void execute(Renderer2D* renderer);
+
+    size_t getLastCommandCount() const { return lastCommandCount_; }
+
+private:
+    std::mutex mutex_;
+    std::vector<RenderCommand> pending_;
+    std::vector<uint32_t> order_;
+    size_t lastCommandCount_ = 0;
+};
+
+#endif
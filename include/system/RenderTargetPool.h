@@ -0,0 +1,61 @@
+#ifndef RENDER_TARGET_POOL_H
+#define RENDER_TARGET_POOL_H
+
+#include <vector>
+#include <glad/glad.h>
+
+#include "system/Variables.h"
+
+#define RENDER_TARGET_POOL_MAX_FREE 8
+
+// Free targets are also evicted, oldest first, once together they take
+// more VRAM than this.
+#define RENDER_TARGET_POOL_FREE_BUDGET (64u * 1024u * 1024u)
+
+// Owns every offscreen framebuffer. Released targets are kept and handed out
+// again to the next request with the same size and format, and the one blit
+// program used to present them is compiled once in initialize().
+class RenderTargetPool {
+public:
+    RenderTargetPool() = default;
+    ~RenderTargetPool();
+
+    RenderTargetPool(const RenderTargetPool&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+    bool initialize();
+    void shutdown();
+
+    RenderContext* acquire(int width, int height, GLenum format = GL_RGBA8);
+    void release(RenderContext* target);
+
+    // Deletes an acquired target instead of keeping it, for sizes that
+    // will not be asked for again.
+    void discard(RenderContext* target);
+
+    // Draws the target's color texture over the whole currently bound
+    // framebuffer and viewport.
+    void blit(const RenderContext* target);
+
+    // Deletes every target that is not currently acquired.
+    void trim();
+
+    size_t getFreeCount() const { return free_.size(); }
+    size_t getFreeBytes() const { return freeBytes_; }
+    size_t getActiveCount() const { return activeCount_; }
+
+private:
+    RenderContext* create(int width, int height, GLenum format);
+    void destroy(RenderContext* target);
+    static size_t getTargetBytes(const RenderContext* target);
+
+    GLuint blitProgram_ = 0;
+    GLuint quadVAO_ = 0;
+    GLuint quadVBO_ = 0;
+
+    std::vector<RenderContext*> free_;
+    size_t freeBytes_ = 0;
+    size_t activeCount_ = 0;
+};
+
+#endif
@@ -7,12 +7,17 @@
 #include <vector>
 #include <string>
 
+#define RENDERER_MITER_LIMIT 4.0f
+
+struct AsyncTexture;
+class PlotBuffer;
+
 struct Color {
     float r, g, b, a;
-    
+
     Color(float r = 1.0f, float g = 1.0f, float b = 1.0f, float a = 1.0f)
         : r(r), g(g), b(b), a(a) {}
-    
+
     Color(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255)
         : r(r / 255.0f), g(g / 255.0f), b(b / 255.0f), a(a / 255.0f) {}
 };
@@ -24,37 +29,183 @@ struct Rect {
     float height;
 };
 
+struct TextureRegion {
+    GLuint textureID = 0;
+    float u0 = 0.0f, v0 = 0.0f;
+    float u1 = 1.0f, v1 = 1.0f;
+    int width = 0;
+    int height = 0;
+
+    bool isValid() const { return textureID != 0; }
+};
+
+struct BatchVertex {
+    float x, y;
+    float u, v;
+    float r, g, b, a;
+};
+
+// Vertex of the SDF shape batch. local is the position relative to the
+// shape's center in pixels; the fragment shader evaluates a rounded box
+// (halfWidth, halfHeight, radius) there, optionally hollowed to a stroke.
+struct ShapeVertex {
+    float x, y;
+    float localX, localY;
+    float halfWidth, halfHeight, radius, stroke;
+    float softness;
+    float r, g, b, a;
+};
+
+// Per-instance data for drawTextureInstanced. The uv rect is in the same
+// top-left based space as TextureRegion, so atlas regions can be copied in.
+struct SpriteInstance {
+    float x, y, width, height;
+    float u0, v0, u1, v1;
+    float r, g, b, a;
+};
+
+inline SpriteInstance makeSpriteInstance(const TextureRegion& region, float x, float y, float width, float height,
+                                         const Color& tint = Color(1.0f, 1.0f, 1.0f, 1.0f)) {
+    return { x, y, width, height, region.u0, region.v0, region.u1, region.v1, tint.r, tint.g, tint.b, tint.a };
+}
+
+enum class LineJoin {
+    MITER,
+    ROUND,
+    BEVEL
+};
+
+struct RenderStats {
+    int drawCalls = 0;
+    int vertices = 0;
+};
+
 class Renderer2D {
 public:
     Renderer2D();
     ~Renderer2D();
-    
+
     bool initialize(int width, int height);
     void setViewport(int width, int height);
     void clear(const Color& color);
-    
+
+    // Geometry submitted between beginBatch() and endBatch() is collected into
+    // one streaming buffer and only drawn when the texture changes, the buffer
+    // fills up or the batch ends. The main loop batches each whole frame;
+    // outside a batch every draw call is flushed immediately.
+    void beginBatch();
+    void endBatch();
+    void flush();
+    bool isBatching() const { return batchDepth_ > 0; }
+
     void drawRect(float x, float y, float width, float height, const Color& color);
     void drawRectOutline(float x, float y, float width, float height, float thickness, const Color& color);
     void drawLine(float x1, float y1, float x2, float y2, float thickness, const Color& color);
-    void drawCircle(float x, float y, float radius, const Color& color, int segments = 32);
-    
+    // segments = 0 draws an exact antialiased circle; 3 or more draws a
+    // regular polygon with that many sides instead.
+    void drawCircle(float x, float y, float radius, const Color& color, int segments = 0);
+
+    // Analytically antialiased shapes, one quad each. thickness is an inner
+    // stroke, so outlines stay inside the given bounds.
+    void drawRing(float x, float y, float radius, float thickness, const Color& color);
+    void drawRoundedRect(float x, float y, float width, float height, float radius, const Color& color);
+    void drawRoundedRectOutline(float x, float y, float width, float height, float radius, float thickness,
+                                const Color& color);
+    void drawShadow(float x, float y, float width, float height, float radius, float blur, const Color& color);
+
+    // One connected line through all points, tessellated into the current
+    // batch. Miter joins sharper than RENDERER_MITER_LIMIT fall back to
+    // bevels. Ends are butt caps; closed joins the last point to the first.
+    void drawPolyline(const glm::vec2* points, size_t count, float thickness, const Color& color,
+                      LineJoin join = LineJoin::MITER, bool closed = false);
+    void drawPolyline(const std::vector<glm::vec2>& points, float thickness, const Color& color,
+                      LineJoin join = LineJoin::MITER, bool closed = false);
+
+    // Draws plot's points as an antialiased mitered line in a single draw
+    // call, expanding the strip on the GPU. dataRange (in data units, y up)
+    // is mapped onto area; the overload without it uses plot's bounds.
+    // Flushes the current batch first so draw order is preserved.
+    void drawPlot(const PlotBuffer& plot, const Rect& dataRange, const Rect& area, float thickness,
+                  const Color& color);
+    void drawPlot(const PlotBuffer& plot, const Rect& area, float thickness, const Color& color);
+
     GLuint loadTexture(const std::string& filepath, bool flipVertically = true);
     void unloadTexture(GLuint textureID);
-    void drawTexture(GLuint textureID, float x, float y, float width, float height, 
+    void drawTexture(GLuint textureID, float x, float y, float width, float height,
+                    const Color& tint = Color(1.0f, 1.0f, 1.0f, 1.0f));
+
+    // Draws the part of the texture covered by the normalized uv rect, with
+    // (0, 0) at the top-left corner of the image.
+    void drawTexture(GLuint textureID, const Rect& uv, float x, float y, float width, float height,
+                    const Color& tint = Color(1.0f, 1.0f, 1.0f, 1.0f));
+    void drawTexture(const TextureRegion& region, float x, float y, float width, float height,
+                    const Color& tint = Color(1.0f, 1.0f, 1.0f, 1.0f));
+
+    // Draws the texture's placeholder until it is resident, then fades the
+    // real texture in over it.
+    void drawTexture(const AsyncTexture& texture, float x, float y, float width, float height,
                     const Color& tint = Color(1.0f, 1.0f, 1.0f, 1.0f));
-    
+
     void drawTextureFullscreen(GLuint textureID, const Color& tint = Color(1.0f, 1.0f, 1.0f, 1.0f));
-    
+    void drawTextureFullscreen(const AsyncTexture& texture, const Color& tint = Color(1.0f, 1.0f, 1.0f, 1.0f));
+
+    // One instanced draw for many copies of the same sprite. Flushes the
+    // current batch first so draw order is preserved.
+    void drawTextureInstanced(GLuint textureID, const SpriteInstance* instances, size_t count);
+    void drawTextureInstanced(GLuint textureID, const std::vector<SpriteInstance>& instances);
+
+    // Appends up to count quads to the batch and points vertices at their
+    // 4 * n uninitialized vertices (top-left, top-right, bottom-right,
+    // bottom-left each), returning n. n is smaller than count when the batch
+    // is full; write those, then ask again for the rest. Used by systems that
+    // generate geometry in bulk; wrap the calls in beginBatch()/endBatch().
+    size_t allocateQuads(GLuint textureID, size_t count, BatchVertex*& vertices);
+
+    const RenderStats& getFrameStats() const { return lastFrameStats_; }
+    void resetFrameStats();
+
 private:
     bool compileShaders();
     void setupBuffers();
-    
+
+    enum class BatchMode {
+        SPRITE,
+        SHAPE
+    };
+
+    void setBatchMode(BatchMode mode);
+    void setBatchTexture(GLuint textureID);
+    void reserveBatch(size_t vertexCount, size_t indexCount);
+    void pushQuad(const BatchVertex& v0, const BatchVertex& v1, const BatchVertex& v2, const BatchVertex& v3);
+    void pushShape(float cx, float cy, float halfWidth, float halfHeight, float radius, float stroke, float softness,
+                   const Color& color);
+    void pushJoin(const glm::vec2& point, const glm::vec2& normalIn, const glm::vec2& normalOut, float halfThickness,
+                  LineJoin join, const Color& color);
+    void flushIfImmediate();
+
     GLuint shaderProgram_;
-    GLuint textureShaderProgram_;
+    GLuint instanceShaderProgram_;
+    GLuint shapeShaderProgram_;
+    GLuint plotShaderProgram_;
+    GLuint whiteTexture_;
     GLuint VAO_, VBO_, EBO_;
+    GLuint shapeVAO_, shapeVBO_;
+    GLuint plotVAO_;
+    GLuint instanceVAO_, instanceQuadVBO_, instanceEBO_, instanceVBO_;
+    size_t instanceCapacity_;
     glm::mat4 projection_;
     int screenWidth_, screenHeight_;
     Color currentColor_;
+
+    std::vector<BatchVertex> batchVertices_;
+    std::vector<ShapeVertex> shapeVertices_;
+    std::vector<unsigned int> batchIndices_;
+    BatchMode batchMode_;
+    GLuint batchTexture_;
+    int batchDepth_;
+
+    RenderStats frameStats_;
+    RenderStats lastFrameStats_;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,90 @@
+#ifndef SCREENSHOT_SERVICE_H
+#define SCREENSHOT_SERVICE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "system/Variables.h"
+
+#define SCREENSHOT_MAX_IN_FLIGHT 3
+#define SCREENSHOT_DIRECTORY "screenshots"
+
+enum class ScreenshotFormat {
+    PNG,
+    QOI
+};
+
+// Takes screenshots without stalling the render thread. capture() queues an
+// asynchronous glReadPixels into a pixel buffer object and fences it; update()
+// maps the buffer once the fence has signaled, usually a frame or two later,
+// and hands it to a worker thread that flips, encodes and writes the file.
+//
+// request() may be called from any thread. capture() and update() must be
+// called on the GL thread.
+class ScreenshotService {
+public:
+    ScreenshotService(const std::string& directory = SCREENSHOT_DIRECTORY,
+                      ScreenshotFormat format = ScreenshotFormat::PNG);
+    ~ScreenshotService();
+
+    ScreenshotService(const ScreenshotService&) = delete;
+    ScreenshotService& operator=(const ScreenshotService&) = delete;
+
+    void request() { requested_ = true; }
+
+    // Reads target back if a screenshot was requested. Call once the frame is
+    // complete, before anything else is drawn into target.
+    void capture(const RenderContext* target);
+    void update();
+
+    // Waits for every outstanding screenshot to be written and frees the
+    // buffers. Needs the GL context.
+    void shutdown();
+
+    void setFormat(ScreenshotFormat format) { format_ = format; }
+    ScreenshotFormat getFormat() const { return format_; }
+
+    int getPendingCount() const;
+
+private:
+    enum class SlotState {
+        FREE,
+        READING,
+        MAPPED,
+        COPIED
+    };
+
+    struct Slot {
+        GLuint buffer = 0;
+        size_t capacity = 0;
+        GLsync fence = nullptr;
+        const unsigned char* mapped = nullptr;
+        int width = 0, height = 0;
+        std::string path;
+        std::atomic<SlotState> state{SlotState::FREE};
+    };
+
+    void workerLoop();
+    void encode(Slot& slot);
+    std::string makePath();
+
+    std::string directory_;
+    ScreenshotFormat format_;
+    std::atomic<bool> requested_{false};
+    int sequence_ = 0;
+
+    Slot slots_[SCREENSHOT_MAX_IN_FLIGHT];
+
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<Slot*> jobs_;
+    bool running_ = true;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <glad/glad.h>
+
+#define SHADER_CACHE_MAGIC 0x43425341u // "ASBC"
+#define SHADER_CACHE_VERSION 1u
+
+struct ShaderCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;
+    uint32_t size;
+};
+
+// Builds every GLSL program in the game. Linked programs are written to a
+// cache directory with glGetProgramBinary, keyed by their sources and the
+// driver's vendor, renderer and version strings, and loaded back on the
+// next start instead of being compiled again. A binary the driver rejects
+// (after a driver update, say) is rebuilt from source and replaced.
+class ShaderCache {
+public:
+    static ShaderCache& getInstance() {
+        static ShaderCache instance;
+        return instance;
+    }
+
+    // Call with the GL context current, before any program is built.
+    // Without it, or without program binary support, programs are always
+    // compiled from source.
+    void initialize(const std::string& directory = "cache/shaders");
+
+    // Returns 0 on failure, after logging the compiler or linker output
+    // under name.
+    GLuint buildProgram(const std::string& name, const char* vertexSource, const char* fragmentSource);
+
+    int getCacheHits() const { return hits_; }
+    int getCacheMisses() const { return misses_; }
+
+private:
+    ShaderCache() = default;
+
+    GLuint compileShader(const std::string& name, GLenum type, const char* source);
+    GLuint linkProgram(const std::string& name, const char* vertexSource, const char* fragmentSource);
+    GLuint loadBinary(const std::string& name, uint64_t key);
+    void storeBinary(const std::string& name, uint64_t key, GLuint program);
+    uint64_t makeKey(const char* vertexSource, const char* fragmentSource) const;
+    std::string getCachePath(uint64_t key) const;
+
+    std::string directory_;
+    std::string driver_;
+    bool available_ = false;
+    int hits_ = 0;
+    int misses_ = 0;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef SIMULATION_THREAD_H
+#define SIMULATION_THREAD_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "system/Variables.h"
+
+class InputRecording;
+
+#define SIMULATION_RATE_HZ 1000
+
+// Most ticks run back to back to catch up after a late wakeup.
+#define SIMULATION_MAX_CATCH_UP 20
+
+// Drains the input queue and runs BaseState::handleEvent/simulate at a fixed
+// rate, independent of rendering. A stalled frame on the render thread never
+// delays input handling or judgement.
+//
+// The current state is only touched with AppContext::stateMutex held; the
+// render thread holds it while switching states.
+class SimulationThread {
+public:
+    // Times passed to simulate() are seconds since epoch, the same clock
+    // TimedInputEvent::timeSeconds is measured on.
+    SimulationThread(AppContext* appContext, std::chrono::high_resolution_clock::time_point epoch,
+                     int rateHz = SIMULATION_RATE_HZ);
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    void start();
+    void stop();
+
+    uint64_t getTickCount() const { return ticks_.load(); }
+
+    // Runs one tick on the calling thread. For offline drivers that step the
+    // simulation themselves instead of calling start().
+    void step(double timeSeconds, float deltaTime) { tick(timeSeconds, deltaTime); }
+
+    // Every handled event is appended to recording, timed relative to the
+    // first tick so a replay can start from zero. Set before start().
+    void setRecording(InputRecording* recording) { recording_ = recording; }
+
+private:
+    void run();
+    void tick(double timeSeconds, float deltaTime);
+
+    AppContext* appContext_;
+    std::chrono::high_resolution_clock::time_point epoch_;
+    int rateHz_;
+    InputRecording* recording_ = nullptr;
+    double recordingOrigin_ = -1.0;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> ticks_{0};
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef SPRITE_SHEET_H
+#define SPRITE_SHEET_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "system/Renderer2D.h"
+
+class TextureAtlas;
+
+enum class AnimationLoop {
+    ONCE,
+    LOOP,
+    PING_PONG
+};
+
+// Frames of an animation, all cut from one texture (or atlas page) so that
+// drawing any frame goes through the same batch. getFrame() is O(1) for
+// uniform timing and for mixed durations whose timeline fits the lookup
+// table at the shortest frame's step; otherwise it binary-searches the few
+// frames of one table slice.
+class SpriteSheet {
+public:
+    SpriteSheet() = default;
+
+    // Cuts the region into a row-major grid. frameCount == 0 uses every cell.
+    void setGrid(const TextureRegion& region, int columns, int rows, int frameCount = 0, float frameRate = 30.0f);
+
+    // Loads the image into the atlas and cuts it into a grid.
+    bool loadGrid(TextureAtlas* atlas, const std::string& name, const std::string& filepath,
+                  int columns, int rows, int frameCount = 0, float frameRate = 30.0f);
+
+    // Packed frames, e.g. separate atlas regions. They have to share a
+    // texture to keep the animation batchable.
+    void addFrame(const TextureRegion& region, float duration);
+
+    void setFrameRate(float frameRate);
+    void setFrameDuration(size_t index, float duration);
+    void setLoop(AnimationLoop loop) { loop_ = loop; }
+
+    size_t getFrameCount() const { return frames_.size(); }
+    float getDuration() const { return duration_; }
+    AnimationLoop getLoop() const { return loop_; }
+
+    size_t getFrameIndex(float time) const;
+    const TextureRegion& getFrame(float time) const;
+
+    void draw(Renderer2D* renderer, float time, float x, float y, float width, float height,
+              const Color& tint = Color(1.0f, 1.0f, 1.0f, 1.0f)) const;
+
+private:
+    void rebuildTimeline();
+    float wrapTime(float time) const;
+
+    std::vector<TextureRegion> frames_;
+    std::vector<float> durations_;
+    std::vector<float> frameEnds_;
+    AnimationLoop loop_ = AnimationLoop::LOOP;
+    float duration_ = 0.0f;
+
+    // Uniform timing needs no table at all.
+    bool uniform_ = true;
+    float frameRate_ = 0.0f;
+
+    // Frame index per lookupStep_ slice of the timeline. The step is the
+    // shortest frame's duration unless that would take more than
+    // MAX_LOOKUP_ENTRIES slices, so a slice usually holds at most one frame
+    // boundary. Lookups binary-search frameEnds_ between the first frames
+    // of a slice and the next one.
+    std::vector<uint32_t> lookup_;
+    float lookupStep_ = 0.0f;
+
+    static const TextureRegion emptyRegion_;
+};
+
+#endif
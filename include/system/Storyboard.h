@@ -0,0 +1,195 @@
+#ifndef STORYBOARD_H
+#define STORYBOARD_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "system/Renderer2D.h"
+#include "system/SpriteSheet.h"
+
+class TextureAtlas;
+
+// Storyboard coordinates; the 4:3 area is centered in the render target
+// and scaled to its height, widescreen storyboards spill over the sides.
+#define STORYBOARD_WIDTH 640.0f
+#define STORYBOARD_HEIGHT 480.0f
+
+// Sprites are indexed by the time buckets their lifetime overlaps.
+#define STORYBOARD_BUCKET_MS 1000.0
+#define STORYBOARD_MAX_BUCKETS 16384
+
+// Larger images (full-screen backgrounds) get their own texture instead of
+// eating most of an atlas page each.
+#define STORYBOARD_ATLAS_MAX_SIZE 1024
+
+enum class StoryboardLayer {
+    BACKGROUND,
+    FAIL,
+    PASS,
+    FOREGROUND,
+    OVERLAY
+};
+
+enum class StoryboardOrigin {
+    TOP_LEFT,
+    CENTRE,
+    CENTRE_LEFT,
+    TOP_RIGHT,
+    BOTTOM_CENTRE,
+    TOP_CENTRE,
+    CENTRE_RIGHT,
+    BOTTOM_LEFT,
+    BOTTOM_RIGHT
+};
+
+// One animated property of one sprite. M, V and C commands are split into
+// a track per component so every track holds scalars.
+enum class StoryboardTrack {
+    ALPHA,
+    X,
+    Y,
+    SCALE,
+    SCALE_X,
+    SCALE_Y,
+    ROTATION,
+    RED,
+    GREEN,
+    BLUE,
+    FLIP_H,
+    FLIP_V,
+    ADDITIVE,
+    COUNT
+};
+
+// Eases one segment of a track from startValue to endValue. Loops are
+// expanded when the storyboard is compiled, so every command is absolute.
+struct StoryboardCommand {
+    double startTime;
+    double endTime;
+    float startValue;
+    float endValue;
+    int easing;
+};
+
+// osu!-style storyboards (.osb, or the [Events] section of a chart).
+// Parsing compiles every sprite's commands into per-track arrays sorted by
+// start time, and indexes sprites by the time buckets they are alive in.
+// update() then only looks at the sprites of the current bucket and
+// binary-searches their tracks, so a frame costs O(active sprites) however
+// many commands the storyboard holds, and seeking anywhere is free.
+//
+// Trigger groups (T) and audio samples are parsed but not played; there
+// is no gameplay to fire them yet.
+class Storyboard {
+public:
+    Storyboard() = default;
+
+    // Frees the textures loadTextures() created, so destroy it on the GL
+    // thread.
+    ~Storyboard();
+
+    Storyboard(const Storyboard&) = delete;
+    Storyboard& operator=(const Storyboard&) = delete;
+
+    // Image paths are resolved against directory. Can run on any thread.
+    bool parseFile(const std::string& path, const std::string& directory);
+    bool parse(const std::string& text, const std::string& directory);
+
+    // Packs every image into the atlas, so the whole storyboard draws in a
+    // few batches. Images too large for a page get their own texture.
+    // GL thread only.
+    void loadTextures(TextureAtlas* atlas, Renderer2D* renderer);
+
+    // Evaluates the sprites alive at timeMs (song time) and culls the ones
+    // that are transparent or outside the width x height target.
+    void update(double timeMs, float width, float height);
+
+    // Draws the result of the last update() through the sprite batch.
+    void render(Renderer2D* renderer) const;
+
+    // Only one of the FAIL and PASS layers is shown.
+    void setPassing(bool passing) { passing_ = passing; }
+
+    void clear();
+
+    size_t getSpriteCount() const { return sprites_.size(); }
+    size_t getCommandCount() const { return commands_.size(); }
+    size_t getActiveCount() const { return activeCount_; }
+    size_t getVisibleCount() const { return drawList_.size(); }
+    double getStartTime() const { return startTime_; }
+    double getEndTime() const { return endTime_; }
+
+private:
+    struct Track {
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
+    struct Sprite {
+        std::string path;
+        StoryboardLayer layer = StoryboardLayer::BACKGROUND;
+        StoryboardOrigin origin = StoryboardOrigin::CENTRE;
+        float x = 0.0f;
+        float y = 0.0f;
+
+        // Animations only.
+        int frameCount = 0;
+        double frameDelay = 0.0;
+        bool loopForever = true;
+        int animation = -1;
+
+        double startTime = 0.0;
+        double endTime = 0.0;
+        Track tracks[(int)StoryboardTrack::COUNT];
+
+        TextureRegion region;
+    };
+
+    struct DrawItem {
+        TextureRegion region;
+        float corners[8];
+        Color color;
+        bool flipH;
+        bool flipV;
+        bool additive;
+    };
+
+    struct ParsedCommand {
+        StoryboardTrack track;
+        StoryboardCommand command;
+    };
+
+    bool parseObject(const std::vector<std::string>& fields, Sprite& sprite) const;
+    bool parseCommand(const std::vector<std::string>& fields, std::vector<ParsedCommand>& out) const;
+    void compileSprite(Sprite& sprite, std::vector<ParsedCommand>& commands);
+    void buildIndex();
+
+    float evaluate(const Sprite& sprite, StoryboardTrack track, double time, float defaultValue) const;
+    bool evaluateFlag(const Sprite& sprite, StoryboardTrack track, double time) const;
+    void evaluateSprite(const Sprite& sprite, double time, float scale, float offsetX, float width, float height);
+
+    const TextureRegion* loadImage(const std::string& path, TextureAtlas* atlas, Renderer2D* renderer);
+
+    std::vector<Sprite> sprites_;
+    std::vector<StoryboardCommand> commands_;
+    std::vector<SpriteSheet> animations_;
+
+    std::vector<std::vector<uint32_t>> buckets_;
+    double bucketMs_ = STORYBOARD_BUCKET_MS;
+    double startTime_ = 0.0;
+    double endTime_ = 0.0;
+
+    std::vector<DrawItem> drawList_;
+    size_t activeCount_ = 0;
+    bool passing_ = true;
+
+    // Images outside the atlas, and failed loads as invalid regions so
+    // they are only reported once.
+    std::vector<GLuint> ownedTextures_;
+    std::unordered_map<std::string, TextureRegion> looseRegions_;
+    Renderer2D* renderer_ = nullptr;
+};
+
+#endif
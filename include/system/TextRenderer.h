@@ -30,6 +30,8 @@ struct Character {
     unsigned int advance;
 };
 
+class Renderer2D;
+
 struct FontKey {
     std::string path;
     int size;
@@ -58,6 +60,10 @@ public:
                     const std::string& fontPath, int fontSize, float lineGap = 0.0f);
     
     void setViewport(int width, int height);
+
+    // Text is drawn straight away, so quads still waiting in this renderer's
+    // batch are flushed first to keep them underneath it.
+    void setBatchRenderer(Renderer2D* renderer) { batchRenderer_ = renderer; }
     
 private:
     bool initFreeType();
@@ -71,6 +77,7 @@ private:
     GLuint VAO_, VBO_;
     glm::mat4 projection_;
     int screenWidth_, screenHeight_;
+    Renderer2D* batchRenderer_ = nullptr;
     
     FontData* getFontData(const std::string& fontPath, int fontSize);
 };
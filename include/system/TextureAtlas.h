@@ -0,0 +1,75 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <glad/glad.h>
+
+#include "system/Renderer2D.h"
+
+// Bottom-left skyline packer. Tracks the top edge of everything placed so far
+// as a list of horizontal segments and drops each new rect as low as it fits.
+class SkylinePacker {
+public:
+    SkylinePacker(int width = 0, int height = 0);
+
+    void reset(int width, int height);
+    bool pack(int width, int height, int& outX, int& outY);
+
+    float getOccupancy() const;
+
+private:
+    struct Segment {
+        int x;
+        int y;
+        int width;
+    };
+
+    bool fits(size_t index, int width, int height, int& outY) const;
+    void addSegment(size_t index, int x, int y, int width, int height);
+
+    int width_ = 0;
+    int height_ = 0;
+    long usedArea_ = 0;
+    std::vector<Segment> skyline_;
+};
+
+// Packs many small images into a few large RGBA pages. Regions are usable as
+// soon as they are added; the atlas owns the page textures.
+class TextureAtlas {
+public:
+    TextureAtlas(int pageWidth = 2048, int pageHeight = 2048, int padding = 2);
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    const TextureRegion* addImage(const std::string& name, const std::string& filepath);
+    const TextureRegion* addPixels(const std::string& name, const unsigned char* rgba, int width, int height);
+
+    const TextureRegion* getRegion(const std::string& name) const;
+    bool hasRegion(const std::string& name) const { return regions_.count(name) > 0; }
+
+    size_t getPageCount() const { return pages_.size(); }
+    GLuint getPageTexture(size_t index) const { return index < pages_.size() ? pages_[index].textureID : 0; }
+
+    void clear();
+
+private:
+    struct Page {
+        GLuint textureID = 0;
+        SkylinePacker packer;
+    };
+
+    Page& createPage();
+
+    int pageWidth_;
+    int pageHeight_;
+    int padding_;
+
+    std::vector<Page> pages_;
+    std::unordered_map<std::string, TextureRegion> regions_;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "system/TextureLoader.h"
+
+#define TEXTURE_CACHE_DEFAULT_BUDGET (256u * 1024u * 1024u)
+
+// Dedupes texture loads by path and load parameters. Textures stay alive
+// while referenced; once released they are kept warm until the cache goes
+// over its VRAM budget, then evicted least recently used first. Loads that
+// failed are dropped as soon as nobody references them, so the next
+// acquire() of the path tries again.
+class TextureCache {
+public:
+    TextureCache(TextureLoader* loader, size_t budgetBytes = TEXTURE_CACHE_DEFAULT_BUDGET);
+    ~TextureCache();
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    TextureHandle acquire(const std::string& filepath, bool flipVertically = true,
+                          const TextureImportOptions& import = {});
+    void release(TextureHandle& handle);
+
+    void setBudget(size_t budgetBytes);
+    size_t getBudget() const { return budgetBytes_; }
+
+    size_t getResidentBytes() const;
+    size_t getEntryCount() const { return entries_.size(); }
+
+    // Evicts unreferenced textures until the cache fits in its budget.
+    void trim();
+    void clear();
+
+private:
+    struct Entry {
+        TextureHandle handle;
+        int references = 0;
+        std::list<std::string>::iterator lruIt;
+        bool inLru = false;
+    };
+
+    using EntryMap = std::unordered_map<std::string, Entry>;
+
+    void evict(EntryMap::iterator it);
+    static std::string makeKey(const std::string& filepath, bool flipVertically, const TextureImportOptions& import);
+    static size_t getTextureBytes(const AsyncTexture& texture);
+
+    TextureLoader* loader_;
+    size_t budgetBytes_;
+
+    EntryMap entries_;
+    std::unordered_map<const AsyncTexture*, std::string> keysByTexture_;
+
+    // Front is the most recently released texture.
+    std::list<std::string> lru_;
+};
+
+#endif
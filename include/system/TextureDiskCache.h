@@ -0,0 +1,86 @@
+#ifndef TEXTURE_DISK_CACHE_H
+#define TEXTURE_DISK_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <utils/MappedFile.h>
+
+#include "system/TextureImport.h"
+
+#define TEXTURE_CACHE_MAGIC 0x43585441u // "ATXC"
+#define TEXTURE_CACHE_VERSION 2u
+
+struct TextureCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceMtime;
+    uint64_t sourceSize;
+    uint64_t contentHash;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipCount;
+    uint32_t flipped;
+    uint32_t channels;
+    uint32_t reserved;
+};
+
+struct TextureCacheLevel {
+    uint64_t offset;
+    uint64_t size;
+    uint32_t width;
+    uint32_t height;
+};
+
+// A pre-decoded 8-bit texture (1 to 4 channels) with its mip chain, or just
+// the base level when imported without mipmaps, mapped straight from the
+// cache file. Level pointers stay valid for the lifetime of the object.
+struct CachedTexture {
+    struct Level {
+        const unsigned char* data;
+        size_t size;
+        int width;
+        int height;
+    };
+
+    MappedFile file;
+    int width = 0;
+    int height = 0;
+    int channels = 4;
+    std::vector<Level> levels;
+
+    size_t getTotalSize() const;
+};
+
+// Directory of pre-decoded textures keyed by source path, flip flag and
+// import options, and validated against the source file's mtime, size and
+// content hash.
+class TextureDiskCache {
+public:
+    TextureDiskCache(const std::string& directory = "cache/textures");
+
+    std::unique_ptr<CachedTexture> load(const std::string& sourcePath, bool flipVertically,
+                                        const TextureImportOptions& import = {});
+    bool store(const std::string& sourcePath, bool flipVertically, const TextureImportOptions& import,
+               const unsigned char* pixels, int width, int height, int channels);
+
+    const std::string& getDirectory() const { return directory_; }
+
+private:
+    struct SourceInfo {
+        uint64_t mtime = 0;
+        uint64_t size = 0;
+    };
+
+    std::string getCachePath(const std::string& sourcePath, bool flipVertically,
+                             const TextureImportOptions& import) const;
+    static bool getSourceInfo(const std::string& sourcePath, SourceInfo& info);
+    static bool hashSourceFile(const std::string& sourcePath, uint64_t& hash);
+
+    std::string directory_;
+    bool available_ = false;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef TEXTURE_IMPORT_H
+#define TEXTURE_IMPORT_H
+
+#include <string>
+#include <vector>
+
+enum class TextureFit {
+    // At least the box on both axes, for fullscreen backgrounds that get
+    // cropped to the screen.
+    COVER,
+    // Within the box on both axes.
+    CONTAIN
+};
+
+// How a texture is brought in on the decode worker. The default imports the
+// image as is, with mipmaps.
+struct TextureImportOptions {
+    // Display size the texture is drawn at; 0 leaves that axis unbounded.
+    // Images are only ever scaled down.
+    int maxWidth = 0;
+    int maxHeight = 0;
+    TextureFit fit = TextureFit::COVER;
+
+    // Textures imported at display size are never minified and can skip
+    // their mip chain, another third off their VRAM.
+    bool mipmaps = true;
+
+    // Part of texture cache keys.
+    std::string getKey() const;
+};
+
+namespace TextureImport {
+    void getImportSize(int width, int height, const TextureImportOptions& options, int& outWidth, int& outHeight);
+
+    // Area-averaging resample for downscaling, interleaved 8-bit pixels with
+    // any channel count. Every destination pixel is the exact coverage
+    // weighted mean of the source pixels under it, so large ratios do not
+    // alias the way a bilinear or small-kernel filter would.
+    void resize(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst, int dstWidth, int dstHeight,
+                int channels);
+}
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glad/glad.h>
+
+#include "system/Renderer2D.h"
+#include "system/TextureDiskCache.h"
+#include "system/TextureImport.h"
+
+enum class TextureState {
+    PENDING,
+    DECODED,
+    RESIDENT,
+    FAILED,
+    CANCELLED
+};
+
+struct AsyncTexture {
+    std::string path;
+    bool flipVertically = true;
+    TextureImportOptions import;
+
+    std::atomic<TextureState> state{TextureState::PENDING};
+    GLuint textureID = 0;
+    int width = 0;
+    int height = 0;
+    size_t gpuBytes = 0;
+
+    // Drawn (tinted) while the texture is still loading.
+    Color placeholder = Color(0.0f, 0.0f, 0.0f, 0.0f);
+    float fadeDuration = 0.25f;
+    float fadeElapsed = 0.0f;
+
+    bool isResident() const { return state.load() == TextureState::RESIDENT; }
+    float getFadeProgress() const;
+
+    // Decoded pixels waiting for the GL thread. Owned by the loader; points
+    // into resizedPixels when the import scaled the image down.
+    unsigned char* pixels = nullptr;
+    std::vector<unsigned char> resizedPixels;
+    int channels = 0;
+    std::unique_ptr<CachedTexture> cached;
+};
+
+using TextureHandle = std::shared_ptr<AsyncTexture>;
+
+// Longest step a fade takes in one frame, so a hitch does not skip it.
+#define TEXTURE_FADE_MAX_STEP (1.0f / 30.0f)
+
+// Decodes images on worker threads and uploads them on the GL thread through
+// a pixel buffer object, a few per frame. loadAsync() never blocks.
+class TextureLoader {
+public:
+    TextureLoader(Renderer2D* renderer, int workerCount = 2);
+    ~TextureLoader();
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    // Optional. When set, workers read pre-decoded textures (with mips) from
+    // it and write every freshly decoded image back into it.
+    void setDiskCache(TextureDiskCache* diskCache) { diskCache_ = diskCache; }
+
+    // Offline renders turn fade-ins off so a texture shows in full on the
+    // frame it arrives.
+    void setFadeEnabled(bool enabled) { fadeEnabled_ = enabled; }
+
+    // Oversized images are scaled down to the import options' display size
+    // on the worker, before they reach the disk cache or the GPU.
+    TextureHandle loadAsync(const std::string& filepath, bool flipVertically = true,
+                            const TextureImportOptions& import = {});
+    void unload(TextureHandle& handle);
+
+    // Call once per frame on the GL thread. Always uploads at least one
+    // texture if any is ready, then keeps going until the budget is spent.
+    void processUploads(double budgetMs = 2.0);
+
+    // Advances fade-ins by the frame's time, so they hold while no frames
+    // are rendered. Call before processUploads().
+    void update(float deltaTime);
+
+    // Textures queued, being decoded or waiting for upload.
+    size_t getPendingCount() const;
+    void shutdown();
+
+private:
+    void workerLoop();
+    bool decodeTexture(AsyncTexture& texture);
+    void uploadTexture(AsyncTexture& texture);
+    void releasePixels(AsyncTexture& texture);
+
+    Renderer2D* renderer_ = nullptr;
+    TextureDiskCache* diskCache_ = nullptr;
+    bool fadeEnabled_ = true;
+
+    std::vector<std::thread> workers_;
+    std::deque<TextureHandle> decodeQueue_;
+    std::deque<TextureHandle> uploadQueue_;
+    std::vector<std::weak_ptr<AsyncTexture>> fading_;
+    size_t decodingCount_ = 0;
+    mutable std::mutex queueMutex_;
+    std::condition_variable cv_;
+    bool running_ = true;
+
+    GLuint uploadPBO_ = 0;
+    size_t uploadPBOSize_ = 0;
+};
+
+#endif
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <mutex>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <system/Logger.h>
@@ -15,27 +17,38 @@ enum AppStateID
 };
 
 extern int FRAMERATE_CAP;
-extern int WINDOW_WIDTH;
-extern int WINDOW_HEIGHT;
+// Written by the main thread's resize callback, read by the render thread.
+extern std::atomic<int> WINDOW_WIDTH;
+extern std::atomic<int> WINDOW_HEIGHT;
 
 inline const std::string MAIN_FONT_PATH = "assets/fonts/GoogleSansCode-Bold.ttf";
 
 class InfoStackManager;
 class FPSCounter;
 class DebugInfo;
+class GPUInfo;
+class GPUProfiler;
 class BaseState;
 class Renderer2D;
 class TextRenderer;
+class TextureLoader;
+class TextureCache;
 class InputQueue;
+class RenderQueue;
+class RenderTargetPool;
+class PostProcess;
+class DynamicResolution;
+class FramePacer;
+class SimulationThread;
+class ScreenshotService;
 
 class ActionBar;
 
 struct RenderContext {
-    GLuint framebuffer;
-    GLuint colorTexture;
-    GLuint shaderProgram;
-    GLuint quadVAO, quadVBO;
-    int width, height;
+    GLuint framebuffer = 0;
+    GLuint colorTexture = 0;
+    GLenum format = GL_RGBA8;
+    int width = 0, height = 0;
 };
 
 struct AppContext;
@@ -44,17 +57,32 @@ using StateSwitcher = void (*)(AppContext*, int, void*);
 struct AppContext
 {
     GLFWwindow* window;
-    RenderContext* renderTarget;
-    bool appQuit = false;
+    RenderContext* renderTarget = nullptr;
+    RenderTargetPool* renderTargetPool = nullptr;
+    PostProcess* postProcess = nullptr;
+    DynamicResolution* dynamicResolution = nullptr;
+    FramePacer* framePacer = nullptr;
+    SimulationThread* simulationThread = nullptr;
+    ScreenshotService* screenshots = nullptr;
+    std::atomic<bool> appQuit{false};
+
+    // Held by the simulation thread while it calls into currentState, and
+    // by the render thread while it switches states.
+    std::mutex stateMutex;
 
     Renderer2D* renderer2D = nullptr;
     TextRenderer* textRenderer = nullptr;
+    TextureLoader* textureLoader = nullptr;
+    TextureCache* textureCache = nullptr;
+    RenderQueue* renderQueue = nullptr;
 
     InputQueue* inputQueue = nullptr;
 
     InfoStackManager* infoStack = nullptr;
     DebugInfo* debugInfo = nullptr;
     FPSCounter* fpsCounter = nullptr;
+    GPUInfo* gpuInfo = nullptr;
+    GPUProfiler* gpuProfiler = nullptr;
 
     StateSwitcher switchState = nullptr;
     BaseState* currentState = nullptr;
@@ -67,6 +95,10 @@ struct AppContext
     float renderWidth = 1920.0f;
     float renderHeight = 1080.0f;
 
+    // Fraction of the logical render size actually rasterized; the final
+    // blit stretches it back up.
+    float renderScale = 1.0f;
+
     int nextState = -1;
     void* nextStatePayload = nullptr;
 
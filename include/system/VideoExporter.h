@@ -0,0 +1,73 @@
+#ifndef VIDEO_EXPORTER_H
+#define VIDEO_EXPORTER_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "system/Variables.h"
+
+#define VIDEO_EXPORT_IN_FLIGHT 3
+#define VIDEO_EXPORT_MAX_QUEUED 8
+
+// Streams rendered frames out as raw top-down RGBA, one width * height * 4
+// block per frame. The output is a file, or with a leading '|' a shell
+// command that receives the frames on stdin, e.g.
+//   |ffmpeg -f rawvideo -pix_fmt rgba -s 1920x1080 -r 60 -i - out.mp4
+//
+// Readback goes through a ring of pixel buffer objects so the GPU is a few
+// frames ahead of the copy, and a writer thread does the I/O. Frames are
+// never dropped: when the writer falls behind, capture() waits for it.
+class VideoExporter {
+public:
+    VideoExporter() = default;
+    ~VideoExporter();
+
+    VideoExporter(const VideoExporter&) = delete;
+    VideoExporter& operator=(const VideoExporter&) = delete;
+
+    bool open(const std::string& output, int width, int height);
+
+    // Queues the target's current contents as the next frame. target must
+    // have the size passed to open(). GL thread only.
+    void capture(const RenderContext* target);
+
+    // Writes every outstanding frame and closes the output. Needs the GL
+    // context.
+    void close();
+
+    bool isOpen() const { return file_ != nullptr; }
+    int getFrameCount() const { return capturedFrames_; }
+
+private:
+    struct Readback {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+    };
+
+    void retire(Readback& readback);
+    void writerLoop();
+
+    FILE* file_ = nullptr;
+    bool isPipe_ = false;
+    int width_ = 0, height_ = 0;
+    size_t frameSize_ = 0;
+
+    Readback readbacks_[VIDEO_EXPORT_IN_FLIGHT];
+    int nextReadback_ = 0;
+    int capturedFrames_ = 0;
+
+    std::thread writer_;
+    std::mutex mutex_;
+    std::condition_variable queueChanged_;
+    std::deque<std::vector<unsigned char>> queued_;
+    std::vector<std::vector<unsigned char>> spare_;
+    bool writing_ = false;
+    bool writeFailed_ = false;
+};
+
+#endif
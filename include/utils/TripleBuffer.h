@@ -0,0 +1,47 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Single producer, single consumer hand-off of the latest value. The
+// producer fills getWriteBuffer() and publish()es it; the consumer calls
+// fetch() and reads getReadBuffer(). Neither side ever waits, and values the
+// consumer was too slow to pick up are simply replaced.
+//
+// The write buffer is recycled and still holds whatever was written into it
+// two publishes ago, so the producer has to fill it in completely.
+template <typename T>
+class TripleBuffer {
+public:
+    T& getWriteBuffer() { return buffers_[writeIndex_]; }
+
+    void publish() {
+        uint8_t previous = middle_.exchange(writeIndex_ | FRESH_BIT, std::memory_order_acq_rel);
+        writeIndex_ = previous & INDEX_MASK;
+    }
+
+    // Returns true if a newer value was picked up.
+    bool fetch() {
+        if (!(middle_.load(std::memory_order_relaxed) & FRESH_BIT)) {
+            return false;
+        }
+
+        uint8_t previous = middle_.exchange(readIndex_, std::memory_order_acq_rel);
+        readIndex_ = previous & INDEX_MASK;
+        return true;
+    }
+
+    const T& getReadBuffer() const { return buffers_[readIndex_]; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t FRESH_BIT = 0x4;
+
+    T buffers_[3] = {};
+    uint8_t writeIndex_ = 0;
+    uint8_t readIndex_ = 1;
+    std::atomic<uint8_t> middle_{2};
+};
+
+#endif
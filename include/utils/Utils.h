@@ -1,6 +1,7 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <cmath>
@@ -19,6 +20,9 @@ namespace Utils {
 
     std::string formatMemorySize(size_t bytes);
 
+    uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
+    std::string toHex(uint64_t value);
+
     double pNorm(const std::vector<double>& values, const std::vector<double>& weights, double P);
     double calculateStandardDeviation(const std::vector<double>& array);
 
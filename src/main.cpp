@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <thread>
 #include <atomic>
@@ -13,10 +15,27 @@
 #include <utils/InfoStackManager.h>
 #include <objects/debug/FPSCounter.h>
 #include <objects/debug/DebugInfo.h>
+#include <objects/debug/GPUInfo.h>
 #include <utils/Utils.h>
 #include "system/InputQueue.h"
+#include "system/InputRecording.h"
+#include "system/AudioMixdown.h"
+#include "system/GLState.h"
+#include "system/DynamicResolution.h"
+#include "system/FrameCapture.h"
+#include "system/FramePacer.h"
+#include "system/GPUProfiler.h"
 #include "system/Renderer2D.h"
+#include "system/RenderQueue.h"
+#include "system/RenderTargetPool.h"
+#include "system/ScreenshotService.h"
+#include "system/ShaderCache.h"
+#include "system/PostProcess.h"
+#include "system/SimulationThread.h"
 #include "system/TextRenderer.h"
+#include "system/TextureLoader.h"
+#include "system/TextureCache.h"
+#include "system/VideoExporter.h"
 #include <system/AudioManager.h>
 
 #include <objects/ActionBar.h>
@@ -29,18 +48,111 @@ void* statePayload = nullptr;
 int curState = -1;
 int prevState = -1;
 
-int WINDOW_WIDTH = 1600;
-int WINDOW_HEIGHT = 900;
+std::atomic<int> WINDOW_WIDTH{1600};
+std::atomic<int> WINDOW_HEIGHT{900};
 int FRAMERATE_CAP = -1;
 
 double lastFrameTime = 0.0;
 std::chrono::high_resolution_clock::time_point programStartTime;
 
-std::atomic<bool> inputThreadRunning{true};
 InputQueue globalInputQueue;
+InputRecording inputRecording;
+InputRecording inputReplay;
 
-GLFWwindow* sharedWindow = nullptr;
-std::mutex windowMutex;
+
+struct LaunchOptions {
+    // Invisible window, fixed timestep, no audio device. Meant for benchmark
+    // and golden-image runs on machines without a display or GPU (Mesa
+    // llvmpipe under Xvfb works).
+    bool headless = false;
+    int frameCount = 0;
+    
+    // Frame rate of the fixed timestep headless runs advance by.
+    int timestepFps = 60;
+    std::string dumpDirectory;
+    int dumpInterval = 1;
+
+    bool dynamicResolution = false;
+    int dynamicResolutionFps = 60;
+
+    int framerateCap = 0;
+    bool lateSampling = false;
+
+    ScreenshotFormat screenshotFormat = ScreenshotFormat::PNG;
+
+    std::string recordInputPath;
+    std::string replayPath;
+
+    // Raw RGBA frames to a file, or to a command with a leading '|'. Implies
+    // headless. exportWidth/Height replace the logical render size.
+    std::string exportPath;
+    std::string exportAudioPath;
+    int exportWidth = 0;
+    int exportHeight = 0;
+};
+
+LaunchOptions parseLaunchOptions(int argc, char* argv[])
+{
+    LaunchOptions options;
+    
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string value;
+        
+        size_t eq = arg.find('=');
+        if (eq != std::string::npos) {
+            value = arg.substr(eq + 1);
+            arg = arg.substr(0, eq);
+        }
+        
+        if (arg == "--headless") {
+            options.headless = true;
+        } else if (arg == "--frames") {
+            options.frameCount = std::max(std::atoi(value.c_str()), 0);
+        } else if (arg == "--dump-frames") {
+            options.dumpDirectory = value.empty() ? "frames" : value;
+        } else if (arg == "--dump-interval") {
+            options.dumpInterval = std::max(std::atoi(value.c_str()), 1);
+        } else if (arg == "--fps-cap") {
+            options.framerateCap = std::atoi(value.c_str());
+        } else if (arg == "--late-sampling") {
+            options.lateSampling = true;
+        } else if (arg == "--record-input") {
+            options.recordInputPath = value.empty() ? "input.rec" : value;
+        } else if (arg == "--replay") {
+            options.replayPath = value;
+            options.headless = true;
+        } else if (arg == "--export") {
+            options.exportPath = value;
+            options.headless = true;
+        } else if (arg == "--export-audio") {
+            options.exportAudioPath = value;
+        } else if (arg == "--export-fps") {
+            options.timestepFps = std::max(std::atoi(value.c_str()), 1);
+        } else if (arg == "--export-size") {
+            if (sscanf(value.c_str(), "%dx%d", &options.exportWidth, &options.exportHeight) != 2 ||
+                options.exportWidth <= 0 || options.exportHeight <= 0) {
+                GAME_LOG_WARN("Invalid export size: " + value);
+                options.exportWidth = options.exportHeight = 0;
+            }
+        } else if (arg == "--screenshot-format") {
+            options.screenshotFormat = value == "qoi" ? ScreenshotFormat::QOI : ScreenshotFormat::PNG;
+        } else if (arg == "--dynamic-resolution") {
+            options.dynamicResolution = true;
+            if (!value.empty() && std::atoi(value.c_str()) > 0) {
+                options.dynamicResolutionFps = std::atoi(value.c_str());
+            }
+        } else {
+            GAME_LOG_WARN("Unknown argument: " + std::string(argv[i]));
+        }
+    }
+    
+    if (!options.exportPath.empty() && options.exportAudioPath.empty()) {
+        options.exportAudioPath = options.exportPath[0] == '|' ? "export.wav" : options.exportPath + ".wav";
+    }
+    
+    return options;
+}
 
 void GLAPIENTRY glDebugOutput(GLenum source, GLenum type, unsigned int id, 
                                GLenum severity, GLsizei length, 
@@ -62,21 +174,6 @@ void framebufferSizeCallback(GLFWwindow* window, int width, int height)
     WINDOW_HEIGHT = height;
 }
 
-void inputPollingThread() {
-    GAME_LOG_DEBUG("Input thread started");
-    
-    while (inputThreadRunning.load()) {
-        std::lock_guard<std::mutex> lock(windowMutex);
-        
-        if (!sharedWindow) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            continue;
-        }
-    }
-    
-    GAME_LOG_DEBUG("Input thread stopped");
-}
-
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
     TimedInputEvent event;
@@ -180,103 +277,44 @@ void setState(AppContext* app, int stateID, void* payload)
     }
 }
 
-RenderContext* createRenderTarget(int width, int height)
+bool acquireRenderTarget(AppContext *app, float width, float height, float scale)
 {
-    RenderContext* ctx = new RenderContext();
-    ctx->width = width;
-    ctx->height = height;
-    
-    glGenFramebuffers(1, &ctx->framebuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, ctx->framebuffer);
-    
-    glGenTextures(1, &ctx->colorTexture);
-    glBindTexture(GL_TEXTURE_2D, ctx->colorTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, ctx->colorTexture, 0);
-    
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        GAME_LOG_ERROR("Framebuffer is not complete!");
-        delete ctx;
-        return nullptr;
-    }
+    int targetWidth = std::max((int)(width * scale), 1);
+    int targetHeight = std::max((int)(height * scale), 1);
     
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    
-    float quadVertices[] = {
-        -1.0f,  1.0f,  0.0f, 1.0f,
-        -1.0f, -1.0f,  0.0f, 0.0f,
-         1.0f, -1.0f,  1.0f, 0.0f,
-         
-        -1.0f,  1.0f,  0.0f, 1.0f,
-         1.0f, -1.0f,  1.0f, 0.0f,
-         1.0f,  1.0f,  1.0f, 1.0f
-    };
-    
-    glGenVertexArrays(1, &ctx->quadVAO);
-    glGenBuffers(1, &ctx->quadVBO);
-    glBindVertexArray(ctx->quadVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, ctx->quadVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-    
-    const char* vertexShaderSource = R"(
-        #version 330 core
-        layout (location = 0) in vec2 aPos;
-        layout (location = 1) in vec2 aTexCoord;
-        out vec2 TexCoord;
-        void main() {
-            gl_Position = vec4(aPos, 0.0, 1.0);
-            TexCoord = aTexCoord;
-        }
-    )";
-    
-    const char* fragmentShaderSource = R"(
-        #version 330 core
-        in vec2 TexCoord;
-        out vec4 FragColor;
-        uniform sampler2D screenTexture;
-        void main() {
-            FragColor = texture(screenTexture, TexCoord);
-        }
-    )";
-    
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vertexShader);
-    
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fragmentShader);
+    if (app->renderTarget && app->renderTarget->width == targetWidth && app->renderTarget->height == targetHeight) {
+        return true;
+    }
     
-    ctx->shaderProgram = glCreateProgram();
-    glAttachShader(ctx->shaderProgram, vertexShader);
-    glAttachShader(ctx->shaderProgram, fragmentShader);
-    glLinkProgram(ctx->shaderProgram);
+    RenderContext* target = app->renderTargetPool->acquire(targetWidth, targetHeight);
+    if (!target) {
+        GAME_LOG_ERROR("Failed to create render target");
+        return false;
+    }
     
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    // Every resolution or dynamic-resolution step leaves the old size
+    // behind for good, so it is deleted rather than pooled.
+    if (app->renderTarget) {
+        app->renderTargetPool->discard(app->renderTarget);
+    }
+    app->renderTarget = target;
     
-    return ctx;
+    return true;
 }
 
-bool setRenderResolution(AppContext *app, float width, float height)
+bool setRenderScale(AppContext *app, float scale)
 {
-    if (app->renderTarget) {
-        glDeleteFramebuffers(1, &app->renderTarget->framebuffer);
-        glDeleteTextures(1, &app->renderTarget->colorTexture);
-        glDeleteVertexArrays(1, &app->renderTarget->quadVAO);
-        glDeleteBuffers(1, &app->renderTarget->quadVBO);
-        delete app->renderTarget;
+    if (!acquireRenderTarget(app, app->renderWidth, app->renderHeight, scale)) {
+        return false;
     }
     
-    app->renderTarget = createRenderTarget((int)width, (int)height);
-    if (!app->renderTarget) {
-        GAME_LOG_ERROR("Failed to create render target");
+    app->renderScale = scale;
+    return true;
+}
+
+bool setRenderResolution(AppContext *app, float width, float height)
+{
+    if (!acquireRenderTarget(app, width, height, app->renderScale)) {
         return false;
     }
     
@@ -294,6 +332,264 @@ bool setRenderResolution(AppContext *app, float width, float height)
     return true;
 }
 
+void renderLoop(AppContext* app, const LaunchOptions& options)
+{
+    glfwMakeContextCurrent(app->window);
+    lastFrameTime = glfwGetTime();
+    
+    int frameIndex = 0;
+    double runStartTime = lastFrameTime;
+    uint64_t simulationTick = 0;
+    
+    VideoExporter* exporter = nullptr;
+    if (!options.exportPath.empty()) {
+        exporter = new VideoExporter();
+        if (!exporter->open(options.exportPath, app->renderTarget->width, app->renderTarget->height)) {
+            app->appQuit = true;
+        }
+        AudioManager::getInstance().beginTimeline();
+    }
+    
+    while (!app->appQuit)
+    {
+        app->framePacer->beginFrame();
+
+        double currentTime = glfwGetTime();
+        float deltaTime = (float)(currentTime - lastFrameTime);
+        lastFrameTime = currentTime;
+        
+        // Frame N has to look the same on every run, so headless runs step
+        // the simulation here, up to this frame's time, instead of on its
+        // own thread.
+        if (options.headless) {
+            deltaTime = 1.0f / options.timestepFps;
+            
+            uint64_t targetTick = (uint64_t)frameIndex * SIMULATION_RATE_HZ / options.timestepFps;
+            for (; simulationTick < targetTick; ++simulationTick) {
+                double tickTime = (double)simulationTick / SIMULATION_RATE_HZ;
+                
+                TimedInputEvent event;
+                while (inputReplay.next(tickTime, event)) {
+                    event.timestamp = std::chrono::high_resolution_clock::now();
+                    app->inputQueue->enqueue(event);
+                }
+                
+                AudioManager::getInstance().setTimelineTime(tickTime);
+                app->simulationThread->step(tickTime, 1.0f / SIMULATION_RATE_HZ);
+            }
+            
+            AudioManager::getInstance().setTimelineTime((double)frameIndex / options.timestepFps);
+        }
+
+        AudioManager::getInstance().update(deltaTime);
+        
+        bool isTransitioning;
+        bool transitioningOut;
+        float transitionProgress;
+        
+        // Input and state switch requests arrive on the simulation thread.
+        {
+            std::lock_guard<std::mutex> lock(app->stateMutex);
+        
+            if (app->isTransitioning)
+            {
+                app->transitionProgress += deltaTime / app->transitionDuration;
+            
+                if (app->transitioningOut && app->transitionProgress >= 1.0f)
+                {
+                    app->currentState = nullptr;
+                    if (state)
+                    {
+                        state->destroy();
+                        delete state;
+                        state = nullptr;
+                    }
+                
+                    curState = app->nextState;
+                    state = createState(curState);
+                    prevState = curState;
+                
+                    if (state != nullptr)
+                    {
+                        state->init(app, app->nextStatePayload);
+                        app->nextStatePayload = nullptr;
+                        app->currentState = state;
+                    }
+                
+                    app->transitioningOut = false;
+                    app->transitionProgress = 0.0f;
+                
+                    lastFrameTime = glfwGetTime();
+                }
+                else if (!app->transitioningOut && app->transitionProgress >= 1.0f)
+                {
+                    app->isTransitioning = false;
+                    app->transitionProgress = 0.0f;
+                }
+            }
+        
+            if (!app->isTransitioning && curState != prevState)
+            {
+                app->currentState = nullptr;
+                if (state)
+                {
+                    state->destroy();
+                    delete state;
+                    state = nullptr;
+                }
+            
+                state = createState(curState);
+                prevState = curState;
+            
+                if (state != nullptr)
+                {
+                    state->init(app, statePayload);
+                    statePayload = nullptr;
+                    app->currentState = state;
+                }
+            }
+        
+            isTransitioning = app->isTransitioning;
+            transitioningOut = app->transitioningOut;
+            transitionProgress = app->transitionProgress;
+        }
+        
+        // Overlays show wall-clock data (FPS, timings, the clock), which
+        // would make exports differ between runs.
+        bool showOverlays = exporter == nullptr;
+        
+        if (app->infoStack && showOverlays) {
+            app->infoStack->updateAll();
+        }
+
+        if (app->actionBar && showOverlays) {
+            app->actionBar->update(deltaTime);
+        }
+        
+        app->textureLoader->update(deltaTime);
+        
+        if (options.headless) {
+            // Don't let decode speed decide which frame a texture shows up in.
+            while (app->textureLoader->getPendingCount() > 0) {
+                app->textureLoader->processUploads();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        } else {
+            app->textureLoader->processUploads();
+        }
+        
+        app->gpuProfiler->beginFrame();
+        app->gpuProfiler->beginScope("Offscreen");
+        
+        GLState& gl = GLState::getInstance();
+        gl.bindFramebuffer(app->renderTarget->framebuffer);
+        glViewport(0, 0, app->renderTarget->width, app->renderTarget->height);
+        app->renderer2D->clear(Color(0.0f, 0.0f, 0.0f, 1.0f));
+
+        // Everything the frame draws through renderer2D is batched; text and
+        // render target switches flush the pending quads themselves.
+        app->renderer2D->beginBatch();
+        
+        if (state != nullptr)
+        {
+            state->update(deltaTime);
+            state->render();
+        }
+        
+        // Commands recorded during render(), possibly from several threads.
+        // They draw over the state's immediate-mode output.
+        app->renderQueue->execute(app->renderer2D);
+
+        if (app->actionBar && showOverlays) {
+            app->actionBar->render();
+        }
+        
+        if (app->infoStack && showOverlays) {
+            app->infoStack->renderAll(app->renderer2D);
+        }
+        
+        if (isTransitioning)
+        {
+            float fadeAlpha;
+            if (transitioningOut) {
+                fadeAlpha = transitionProgress;
+            } else {
+                fadeAlpha = 1.0f - transitionProgress;
+            }
+            
+            app->renderer2D->drawRect(0, 0, app->renderWidth, app->renderHeight, 
+                                     Color(0, 0, 0, (uint8_t)(fadeAlpha * 255)));
+        }
+        
+        app->renderer2D->endBatch();
+        app->renderer2D->resetFrameStats();
+        
+        if (!options.dumpDirectory.empty() && frameIndex % options.dumpInterval == 0) {
+            char name[32];
+            snprintf(name, sizeof(name), "frame_%06d.png", frameIndex);
+            FrameCapture::savePNG(app->renderTarget, options.dumpDirectory + "/" + name);
+        }
+        
+        if (exporter) {
+            exporter->capture(app->renderTarget);
+        }
+        
+        app->screenshots->capture(app->renderTarget);
+        app->screenshots->update();
+        
+        app->gpuProfiler->endScope();
+        app->gpuProfiler->beginScope("Blit");
+        
+        gl.bindFramebuffer(0);
+        glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        
+        app->renderTargetPool->blit(app->renderTarget);
+        
+        app->gpuProfiler->endScope();
+        
+        if (state != nullptr)
+        {
+            GPUProfileScope postBufferScope(app->gpuProfiler, "PostBuffer");
+            state->postBuffer();
+        }
+        
+        app->gpuProfiler->endFrame();
+        
+        if (app->dynamicResolution) {
+            double cpuMs = (glfwGetTime() - currentTime) * 1000.0;
+            if (app->dynamicResolution->update(cpuMs, app->gpuProfiler->getFrameMilliseconds())) {
+                setRenderScale(app, app->dynamicResolution->getScale());
+            }
+        }
+        
+        glfwSwapBuffers(app->window);
+        app->framePacer->endFrame();
+        
+        frameIndex++;
+        if (options.frameCount > 0 && frameIndex >= options.frameCount) {
+            app->appQuit = true;
+        }
+    }
+    
+    if (options.headless) {
+        double elapsed = glfwGetTime() - runStartTime;
+        GAME_LOG_INFO("Headless run: " + std::to_string(frameIndex) + " frames in " + std::to_string(elapsed) + "s (" +
+                      std::to_string(frameIndex > 0 ? elapsed * 1000.0 / frameIndex : 0.0) + "ms/frame)");
+    }
+    
+    if (exporter) {
+        exporter->close();
+        delete exporter;
+        
+        std::vector<AudioTimelineEvent> timeline = AudioManager::getInstance().endTimeline();
+        AudioMixdown::render(timeline, (double)frameIndex / options.timestepFps, options.exportAudioPath);
+    }
+    
+    glfwMakeContextCurrent(nullptr);
+}
+
 int main(int argc, char* argv[])
 {
     InstallCrashHandler("logs");
@@ -301,6 +597,8 @@ int main(int argc, char* argv[])
     
     programStartTime = std::chrono::high_resolution_clock::now();
     
+    LaunchOptions options = parseLaunchOptions(argc, argv);
+    
     glfwSetErrorCallback(glfwErrorCallback);
     
     if (!glfwInit()) {
@@ -312,6 +610,10 @@ int main(int argc, char* argv[])
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+    
+    if (options.headless) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    }
 
     GAME_LOG_INFO("GLFW initialized successfully");
     
@@ -322,6 +624,15 @@ int main(int argc, char* argv[])
     WINDOW_HEIGHT = 900;
     FRAMERATE_CAP = 999;
     
+    if (options.framerateCap != 0) {
+        FRAMERATE_CAP = options.framerateCap;
+    }
+    
+    // Benchmarks want to know how fast a frame can go.
+    if (options.headless) {
+        FRAMERATE_CAP = -1;
+    }
+    
     std::string title = std::string(GAME_NAME) + " v" + GAME_VERSION;
     GLFWwindow* window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, title.c_str(), nullptr, nullptr);
     
@@ -333,13 +644,15 @@ int main(int argc, char* argv[])
         return -1;
     }
 
-    GLFWmonitor* primary = glfwGetPrimaryMonitor();
-    const GLFWvidmode* mode = glfwGetVideoMode(primary);
-    int xPos = (mode->width - WINDOW_WIDTH) / 2;
-    int yPos = (mode->height - WINDOW_HEIGHT) / 2;
-    glfwSetWindowPos(window, xPos, yPos);
+    if (!options.headless) {
+        GLFWmonitor* primary = glfwGetPrimaryMonitor();
+        const GLFWvidmode* mode = glfwGetVideoMode(primary);
+        int xPos = (mode->width - WINDOW_WIDTH) / 2;
+        int yPos = (mode->height - WINDOW_HEIGHT) / 2;
+        glfwSetWindowPos(window, xPos, yPos);
 
-    Utils::loadWindowIcon(window, "assets/icon.png");
+        Utils::loadWindowIcon(window, "assets/icon.png");
+    }
     
     glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
@@ -364,6 +677,15 @@ int main(int argc, char* argv[])
     glDebugMessageCallback(glDebugOutput, nullptr);
 #endif
 
+    if (!GLState::getInstance().initialize()) {
+        GAME_LOG_ERROR("Failed to initialize GL state tracker");
+
+        Logger::getInstance().shutdown();
+        return -1;
+    }
+
+    ShaderCache::getInstance().initialize("cache/shaders");
+
     GAME_LOG_INFO("OpenGL initialized successfully");
     
     auto *app = new AppContext();
@@ -372,11 +694,28 @@ int main(int argc, char* argv[])
     app->inputQueue = &globalInputQueue;
 
     glfwSetWindowUserPointer(window, app);
+    
+    app->renderTargetPool = new RenderTargetPool();
+    if (!app->renderTargetPool->initialize()) {
+        GAME_LOG_ERROR("Failed to initialize render target pool");
+
+        Logger::getInstance().shutdown();
+        return -1;
+    }
+    
+    if (options.exportWidth > 0) {
+        app->renderWidth = (float)options.exportWidth;
+        app->renderHeight = (float)options.exportHeight;
+    }
+    
     setRenderResolution(app, app->renderWidth, app->renderHeight);
     
-    {
-        std::lock_guard<std::mutex> lock(windowMutex);
-        sharedWindow = window;
+    app->postProcess = new PostProcess(app->renderTargetPool);
+    if (!app->postProcess->initialize()) {
+        GAME_LOG_ERROR("Failed to initialize post-processing");
+
+        Logger::getInstance().shutdown();
+        return -1;
     }
     
     app->renderer2D = new Renderer2D();
@@ -396,7 +735,17 @@ int main(int argc, char* argv[])
         return -1;
     }
 
+    app->textRenderer->setBatchRenderer(app->renderer2D);
     GAME_LOG_INFO("Text renderer initialized successfully");
+    GAME_LOG_INFO("Shader programs: " + std::to_string(ShaderCache::getInstance().getCacheHits()) + " from cache, " +
+                  std::to_string(ShaderCache::getInstance().getCacheMisses()) + " compiled");
+
+    static TextureDiskCache textureDiskCache("cache/textures");
+    app->textureLoader = new TextureLoader(app->renderer2D);
+    app->textureLoader->setDiskCache(&textureDiskCache);
+    app->textureLoader->setFadeEnabled(!options.headless);
+    app->textureCache = new TextureCache(app->textureLoader);
+    app->renderQueue = new RenderQueue();
 
     app->actionBar = new ActionBar(app);
     app->actionBar->addAddon(new ActionTest(app));
@@ -414,9 +763,30 @@ int main(int argc, char* argv[])
     app->infoStack->addInfo(debugInfo);
     app->debugInfo = debugInfo;
 
+    app->gpuProfiler = new GPUProfiler();
+    app->gpuProfiler->initialize();
+
+    app->framePacer = new FramePacer(FRAMERATE_CAP);
+    app->framePacer->setLateSampling(options.lateSampling);
+
+    app->screenshots = new ScreenshotService(SCREENSHOT_DIRECTORY, options.screenshotFormat);
+
+    if (options.dynamicResolution && options.exportPath.empty()) {
+        DynamicResolutionConfig config;
+        config.targetFrameMs = 1000.0 / options.dynamicResolutionFps;
+        app->dynamicResolution = new DynamicResolution(config);
+        GAME_LOG_INFO("Dynamic resolution enabled, target " + std::to_string(config.targetFrameMs) + "ms");
+    }
+
+    GPUInfo* gpuInfo = new GPUInfo(app->textRenderer, MAIN_FONT_PATH, 16, 8.0f);
+    gpuInfo->setAppContext(app);
+    app->infoStack->addInfo(gpuInfo);
+    app->gpuInfo = gpuInfo;
+
     GAME_LOG_INFO("App context and subsystems initialized successfully");
 
-    if (!AudioManager::getInstance().initialize()) {
+    // Device 0 is BASS's "no sound" device, which needs no hardware.
+    if (!AudioManager::getInstance().initialize(44100, options.headless ? 0 : -1)) {
         GAME_LOG_ERROR("Failed to initialize audio system");
         return -1;
     }
@@ -426,162 +796,59 @@ int main(int argc, char* argv[])
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
-    std::thread inputThread(inputPollingThread);
-    GAME_LOG_DEBUG("Initialization successful. Input thread running on separate thread.");
-    
     curState = STATE_MAIN_MENU;
-    lastFrameTime = glfwGetTime();
     
-    while (!glfwWindowShouldClose(window) && !app->appQuit)
+    // The render thread takes over the context; this thread only pumps
+    // window events so input is timestamped the moment it arrives.
+    glfwMakeContextCurrent(nullptr);
+    
+    app->simulationThread = new SimulationThread(app, programStartTime);
+    
+    if (!options.replayPath.empty() && !inputReplay.load(options.replayPath)) {
+        app->appQuit = true;
+    }
+    
+    if (!options.exportPath.empty() && options.frameCount == 0) {
+        double seconds = inputReplay.size() > 0 ? inputReplay.getDuration() + 1.0 : 10.0;
+        options.frameCount = (int)std::ceil(seconds * options.timestepFps);
+    }
+    
+    if (!options.recordInputPath.empty()) {
+        app->simulationThread->setRecording(&inputRecording);
+    }
+    
+    // Headless runs step the simulation from the render loop.
+    if (!options.headless) {
+        app->simulationThread->start();
+    }
+    
+    std::thread renderThread(renderLoop, app, std::cref(options));
+    GAME_LOG_DEBUG("Initialization successful. Simulation and render threads running.");
+    
+    while (!app->appQuit)
     {
-        glfwPollEvents();
-
-        double currentTime = glfwGetTime();
-        float deltaTime = (float)(currentTime - lastFrameTime);
-        lastFrameTime = currentTime;
-
-        AudioManager::getInstance().update(deltaTime);
+        glfwWaitEventsTimeout(0.01);
         
-        TimedInputEvent inputEvent;
-        while (globalInputQueue.dequeue(inputEvent)) {
-            auto now = std::chrono::high_resolution_clock::now();
-            double latencyMs = std::chrono::duration<double, std::milli>(now - inputEvent.timestamp).count();
-            
-            if (latencyMs > 5.0) {
-                GAME_LOG_DEBUG("High input latency: " + std::to_string(latencyMs) + "ms");
-            }
-            
-            if (inputEvent.key == GLFW_KEY_ESCAPE && inputEvent.type == TimedInputEvent::KEY_DOWN) {
-                app->appQuit = true;
-            }
-            
-            if (state != nullptr) {
-                state->handleEvent(inputEvent);
-            }
+        if (glfwWindowShouldClose(window)) {
+            app->appQuit = true;
         }
-        
-        if (app->isTransitioning)
-        {
-            app->transitionProgress += deltaTime / app->transitionDuration;
-            
-            if (app->transitioningOut && app->transitionProgress >= 1.0f)
-            {
-                if (state)
-                {
-                    state->destroy();
-                    delete state;
-                    state = nullptr;
-                }
-                
-                curState = app->nextState;
-                state = createState(curState);
-                prevState = curState;
-                
-                if (state != nullptr)
-                {
-                    state->init(app, app->nextStatePayload);
-                    app->nextStatePayload = nullptr;
-                    app->currentState = state;
-                }
-                
-                app->transitioningOut = false;
-                app->transitionProgress = 0.0f;
-                
-                lastFrameTime = glfwGetTime();
-            }
-            else if (!app->transitioningOut && app->transitionProgress >= 1.0f)
-            {
-                app->isTransitioning = false;
-                app->transitionProgress = 0.0f;
-            }
-        }
-        
-        if (!app->isTransitioning && curState != prevState)
-        {
-            if (state)
-            {
-                state->destroy();
-                delete state;
-                state = nullptr;
-            }
-            
-            state = createState(curState);
-            prevState = curState;
-            
-            if (state != nullptr)
-            {
-                state->init(app, statePayload);
-                statePayload = nullptr;
-                app->currentState = state;
-            }
-        }
-        
-        if (app->infoStack) {
-            app->infoStack->updateAll();
-        }
-
-        if (app->actionBar) {
-            app->actionBar->update(deltaTime);
-        }
-        
-        glBindFramebuffer(GL_FRAMEBUFFER, app->renderTarget->framebuffer);
-        glViewport(0, 0, (int)app->renderWidth, (int)app->renderHeight);
-        app->renderer2D->clear(Color(0.0f, 0.0f, 0.0f, 1.0f));
-        
-        if (state != nullptr)
-        {
-            state->update(deltaTime);
-            state->render();
-        }
-
-        if (app->actionBar) {
-            app->actionBar->render();
-        }
-        
-        if (app->infoStack) {
-            app->infoStack->renderAll(app->renderer2D);
-        }
-        
-        if (app->isTransitioning)
-        {
-            float fadeAlpha;
-            if (app->transitioningOut) {
-                fadeAlpha = app->transitionProgress;
-            } else {
-                fadeAlpha = 1.0f - app->transitionProgress;
-            }
-            
-            app->renderer2D->drawRect(0, 0, app->renderWidth, app->renderHeight, 
-                                     Color(0, 0, 0, (uint8_t)(fadeAlpha * 255)));
-        }
-        
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-        
-        glUseProgram(app->renderTarget->shaderProgram);
-        glBindVertexArray(app->renderTarget->quadVAO);
-        glBindTexture(GL_TEXTURE_2D, app->renderTarget->colorTexture);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        
-        if (state != nullptr)
-        {
-            state->postBuffer();
-        }
-        
-        glfwSwapBuffers(window);
     }
     
-    inputThreadRunning.store(false);
+    renderThread.join();
+    app->simulationThread->stop();
     
-    {
-        std::lock_guard<std::mutex> lock(windowMutex);
-        sharedWindow = nullptr;
+    if (!options.recordInputPath.empty()) {
+        inputRecording.save(options.recordInputPath);
     }
     
-    inputThread.join();
+    glfwMakeContextCurrent(window);
+    
+    if (app->simulationThread) {
+        delete app->simulationThread;
+        app->simulationThread = nullptr;
+    }
     
+    app->currentState = nullptr;
     if (state != nullptr)
     {
         state->destroy();
@@ -589,7 +856,6 @@ int main(int argc, char* argv[])
         state = nullptr;
     }
     
-    Logger::getInstance().shutdown();
     AudioManager::getInstance().shutdown();
     
     if (app->infoStack) {
@@ -604,11 +870,56 @@ int main(int argc, char* argv[])
     
     app->fpsCounter = nullptr;
     app->debugInfo = nullptr;
+    app->gpuInfo = nullptr;
+
+    if (app->dynamicResolution) {
+        delete app->dynamicResolution;
+        app->dynamicResolution = nullptr;
+    }
+
+    if (app->screenshots) {
+        delete app->screenshots;
+        app->screenshots = nullptr;
+    }
+
+    if (app->framePacer) {
+        delete app->framePacer;
+        app->framePacer = nullptr;
+    }
+
+    if (app->gpuProfiler) {
+        delete app->gpuProfiler;
+        app->gpuProfiler = nullptr;
+    }
     
     if (app->renderTarget) {
-        glDeleteFramebuffers(1, &app->renderTarget->framebuffer);
-        glDeleteTextures(1, &app->renderTarget->colorTexture);
-        delete app->renderTarget;
+        app->renderTargetPool->release(app->renderTarget);
+        app->renderTarget = nullptr;
+    }
+    
+    if (app->postProcess) {
+        delete app->postProcess;
+        app->postProcess = nullptr;
+    }
+    
+    if (app->renderTargetPool) {
+        delete app->renderTargetPool;
+        app->renderTargetPool = nullptr;
+    }
+    
+    if (app->renderQueue) {
+        delete app->renderQueue;
+        app->renderQueue = nullptr;
+    }
+    
+    if (app->textureCache) {
+        delete app->textureCache;
+        app->textureCache = nullptr;
+    }
+    
+    if (app->textureLoader) {
+        app->textureLoader->shutdown();
+        delete app->textureLoader;
     }
     
     if (app->renderer2D) {
@@ -621,8 +932,13 @@ int main(int argc, char* argv[])
     
     delete app;
     
+    GLState::getInstance().shutdown();
+    
     glfwDestroyWindow(window);
     glfwTerminate();
     
+    // Last, so pending screenshot writes and shutdown errors still get logged.
+    Logger::getInstance().shutdown();
+    
     return 0;
 }
\ No newline at end of file
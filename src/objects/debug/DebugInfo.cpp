@@ -1,3 +1,4 @@
+#include <cmath>
 #include <iomanip>
 #include <sstream>
 
@@ -16,6 +17,7 @@
 #include <utils/Utils.h>
 #include <BaseState.h>
 #include <objects/debug/DebugInfo.h>
+#include <system/FramePacer.h>
 
 DebugInfo::DebugInfo(TextRenderer* renderer, const std::string& fontPath, int fontSize, float yPos)
     : FPSCounter(renderer, fontPath, fontSize, yPos)
@@ -41,6 +43,22 @@ void DebugInfo::update()
 
     ss << "STATE: " << appContext->currentState->getStateName();
 
+    if (appContext->renderer2D) {
+        const RenderStats& stats = appContext->renderer2D->getFrameStats();
+        ss << "\nDRAWS: " << stats.drawCalls << " (" << stats.vertices << " verts)";
+    }
+
+    if (appContext->framePacer && appContext->framePacer->getFramerateCap() > 0) {
+        const FramePacer* pacer = appContext->framePacer;
+        ss << "\nPACING: " << pacer->getFramerateCap() << " fps, jitter " << pacer->getJitterMs()
+           << "ms (max " << pacer->getMaxDeviationMs() << "ms)";
+    }
+
+    if (appContext->dynamicResolution && appContext->renderTarget) {
+        ss << "\nRES: " << appContext->renderTarget->width << "x" << appContext->renderTarget->height
+           << " (" << (int)std::round(appContext->renderScale * 100.0f) << "%)";
+    }
+
     textObject_->setText(ss.str());
 }
 
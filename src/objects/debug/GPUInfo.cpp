@@ -0,0 +1,52 @@
+#include <iomanip>
+#include <sstream>
+#include <GLFW/glfw3.h>
+
+#include <system/Variables.h>
+#include <system/GPUProfiler.h>
+#include <objects/debug/GPUInfo.h>
+
+GPUInfo::GPUInfo(TextRenderer* renderer, const std::string& fontPath, int fontSize, float yPos)
+    : FPSCounter(renderer, fontPath, fontSize, yPos)
+{
+
+}
+
+void GPUInfo::update()
+{
+    if (!textObject_)
+        return;
+
+    AppContext* appContext = getAppContext();
+    if (!appContext || !appContext->gpuProfiler)
+        return;
+
+    double currentTime = glfwGetTime();
+    refreshAccumulator_ += currentTime - lastUpdateTime_;
+    lastUpdateTime_ = currentTime;
+
+    if (refreshAccumulator_ < 0.1)
+        return;
+    refreshAccumulator_ = 0.0;
+
+    GPUProfiler* profiler = appContext->gpuProfiler;
+    if (!profiler->isSupported()) {
+        textObject_->setText("GPU: N/A");
+        return;
+    }
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << "GPU: " << profiler->getFrameMilliseconds() << "ms";
+
+    for (const auto& scope : profiler->getResults()) {
+        ss << "\n" << std::string((scope.depth + 1) * 2, ' ') << scope.name << ": " << scope.milliseconds << "ms";
+    }
+
+    textObject_->setText(ss.str());
+}
+
+void GPUInfo::render(Renderer2D* renderer)
+{
+    FPSCounter::render(renderer);
+}
@@ -1,5 +1,6 @@
 #include <states/MainMenuState.h>
 #include <system/AudioManager.h>
+#include <system/TextureCache.h>
 
 void MainMenuState::createButton(const std::string& label, int targetState, float y)
 {
@@ -14,10 +15,17 @@ void MainMenuState::init(AppContext* appContext, void* payload)
 {
     BaseState::init(appContext, payload);
 
-    backgroundTexture_ = appContext->renderer2D->loadTexture("assets/songs/EGOIST - The Everlasting Guilty Crown/22627712_p0.jpg");
-    if (backgroundTexture_ == 0) {
-        GAME_LOG_WARN("Failed to load menu background, using solid color");
-    }
+    // Only ever drawn fullscreen, so import it at the logical render size.
+    TextureImportOptions backgroundImport;
+    backgroundImport.maxWidth = (int)appContext->renderWidth;
+    backgroundImport.maxHeight = (int)appContext->renderHeight;
+    backgroundImport.fit = TextureFit::COVER;
+    backgroundImport.mipmaps = false;
+
+    backgroundTexture_ = appContext->textureCache->acquire(
+        "assets/songs/EGOIST - The Everlasting Guilty Crown/22627712_p0.jpg", true, backgroundImport);
+    layer_ = new CachedLayer(appContext);
+    backgroundBlur_ = new CachedBlur(appContext, 3);
 
     float centerY = screenHeight_ / 2.0f;
     createButton("Play", STATE_MAIN_MENU, centerY - 30.0f);
@@ -47,16 +55,49 @@ void MainMenuState::update(float deltaTime)
 
 void MainMenuState::render()
 {
-    if (backgroundTexture_ != 0) {
+    snapshots_.fetch();
+    int hovered = snapshots_.getReadBuffer().hoveredIndex;
+    if (hovered != renderedHoverIndex_) {
+        renderedHoverIndex_ = hovered;
+        layer_->invalidate();
+    }
+
+    // The menu only changes while the background fades in or the hovered
+    // button changes; every other frame is a single textured quad. A
+    // background that is still loading or failed draws as its placeholder,
+    // which does not change.
+    if (backgroundTexture_ && backgroundTexture_->isResident() && backgroundTexture_->getFadeProgress() < 1.0f) {
+        layer_->invalidate();
+    }
+
+    if (layer_->begin()) {
+        renderLayer();
+        layer_->end();
+    }
+
+    if (layer_->isValid()) {
+        layer_->composite();
+    } else {
+        renderLayer();
+    }
+}
+
+void MainMenuState::renderLayer()
+{
+    if (backgroundTexture_ && backgroundTexture_->isResident()) {
+        // Blurred once when the texture arrives, then reused from the cache.
+        GLuint blurred = backgroundBlur_->get(backgroundTexture_->textureID,
+                                              backgroundTexture_->width, backgroundTexture_->height);
+
         appContext->renderer2D->drawTextureFullscreen(
-            backgroundTexture_, 
-            Color(0.2f, 0.2f, 0.2f, 1.0f)
+            blurred ? blurred : backgroundTexture_->textureID,
+            Color(0.2f, 0.2f, 0.2f, backgroundTexture_->getFadeProgress())
         );
     }
 
     for (size_t i = 0; i < buttons_.size(); ++i) {
         if (buttons_[i].text) {
-            if ((int)i == hoveredIndex_) {
+            if ((int)i == renderedHoverIndex_) {
                 buttons_[i].text->setColor(1.0f, 1.0f, 0.0f, 1.0f);
             } else {
                 buttons_[i].text->setColor(1.0f, 1.0f, 1.0f, 1.0f);
@@ -71,11 +112,16 @@ void MainMenuState::destroy()
     AudioManager::getInstance().fadeMusicOut(1.0f);
     AudioManager::getInstance().unloadMusic("menu_theme");
 
-    if (backgroundTexture_ != 0) {
-        appContext->renderer2D->unloadTexture(backgroundTexture_);
-        backgroundTexture_ = 0;
+    if (backgroundTexture_) {
+        appContext->textureCache->release(backgroundTexture_);
     }
 
+    delete layer_;
+    layer_ = nullptr;
+
+    delete backgroundBlur_;
+    backgroundBlur_ = nullptr;
+
     for (auto& b : buttons_) {
         delete b.text;
     }
@@ -84,6 +130,7 @@ void MainMenuState::destroy()
 
 void MainMenuState::updateHover(float x, float y)
 {
+    int previous = hoveredIndex_;
     hoveredIndex_ = -1;
     for (size_t i = 0; i < buttons_.size(); ++i) {
         if (buttons_[i].text && buttons_[i].text->hitTest(x, y)) {
@@ -91,6 +138,11 @@ void MainMenuState::updateHover(float x, float y)
             break;
         }
     }
+
+    if (hoveredIndex_ != previous) {
+        snapshots_.getWriteBuffer().hoveredIndex = hoveredIndex_;
+        snapshots_.publish();
+    }
 }
 
 void MainMenuState::activateButton(int index)
@@ -157,6 +157,7 @@ bool AudioManager::playSound(const std::string& name, float volume, bool loop) {
     }
     
     BASS_ChannelPlay(channel, TRUE);
+    recordTimeline(AudioTimelineEvent::PLAY, name, it->second, finalVolume);
     return true;
 }
 
@@ -190,6 +191,7 @@ bool AudioManager::playMusic(const std::string& name, float volume, bool loop) {
     }
     
     BASS_ChannelPlay(it->second.stream, TRUE);
+    recordTimeline(AudioTimelineEvent::PLAY, name, it->second, finalVolume);
     return true;
 }
 
@@ -216,6 +218,7 @@ bool AudioManager::playStream(const std::string& name, float volume, bool loop)
     }
     
     BASS_ChannelPlay(it->second.stream, TRUE);
+    recordTimeline(AudioTimelineEvent::PLAY, name, it->second, finalVolume);
     return true;
 }
 
@@ -225,6 +228,7 @@ void AudioManager::pauseMusic() {
     auto it = audioHandles_.find(currentMusic_);
     if (it != audioHandles_.end() && it->second.stream) {
         BASS_ChannelPause(it->second.stream);
+        recordTimeline(AudioTimelineEvent::PAUSE, currentMusic_, it->second);
     }
 }
 
@@ -234,6 +238,7 @@ void AudioManager::resumeMusic() {
     auto it = audioHandles_.find(currentMusic_);
     if (it != audioHandles_.end() && it->second.stream) {
         BASS_ChannelPlay(it->second.stream, FALSE);
+        recordTimeline(AudioTimelineEvent::RESUME, currentMusic_, it->second);
     }
 }
 
@@ -243,6 +248,7 @@ void AudioManager::stopMusic() {
     auto it = audioHandles_.find(currentMusic_);
     if (it != audioHandles_.end() && it->second.stream) {
         BASS_ChannelStop(it->second.stream);
+        recordTimeline(AudioTimelineEvent::STOP, currentMusic_, it->second);
     }
     
     currentMusic_.clear();
@@ -256,6 +262,7 @@ void AudioManager::stopSound(const std::string& name) {
     
     if (it->second.type == AudioType::SOUND && it->second.sample) {
         BASS_SampleStop(it->second.sample);
+        recordTimeline(AudioTimelineEvent::STOP, name, it->second);
     }
 }
 
@@ -263,6 +270,7 @@ void AudioManager::stopAllSounds() {
     for (auto& pair : audioHandles_) {
         if (pair.second.type == AudioType::SOUND && pair.second.sample) {
             BASS_SampleStop(pair.second.sample);
+            recordTimeline(AudioTimelineEvent::STOP, pair.first, pair.second);
         }
     }
 }
@@ -274,6 +282,7 @@ void AudioManager::stopAll() {
     for (auto& pair : audioHandles_) {
         if (pair.second.stream) {
             BASS_ChannelStop(pair.second.stream);
+            recordTimeline(AudioTimelineEvent::STOP, pair.first, pair.second);
         }
     }
 }
@@ -303,6 +312,7 @@ void AudioManager::setVolume(const std::string& name, float volume) {
         float categoryVolume = (it->second.type == AudioType::MUSIC) ? musicVolume_ : soundVolume_;
         float finalVolume = it->second.baseVolume * categoryVolume * masterVolume_;
         BASS_ChannelSetAttribute(it->second.stream, BASS_ATTRIB_VOL, finalVolume);
+        recordTimeline(AudioTimelineEvent::VOLUME, name, it->second, finalVolume);
     }
 }
 
@@ -312,6 +322,7 @@ void AudioManager::applyVolumes() {
             float categoryVolume = (pair.second.type == AudioType::MUSIC) ? musicVolume_ : soundVolume_;
             float finalVolume = pair.second.baseVolume * categoryVolume * masterVolume_;
             BASS_ChannelSetAttribute(pair.second.stream, BASS_ATTRIB_VOL, finalVolume);
+            recordTimeline(AudioTimelineEvent::VOLUME, pair.first, pair.second, finalVolume);
         }
     }
 }
@@ -347,6 +358,7 @@ void AudioManager::setMusicPosition(double seconds) {
     if (it != audioHandles_.end() && it->second.stream) {
         QWORD pos = BASS_ChannelSeconds2Bytes(it->second.stream, seconds);
         BASS_ChannelSetPosition(it->second.stream, pos, BASS_POS_BYTE);
+        recordTimeline(AudioTimelineEvent::SEEK, currentMusic_, it->second, 1.0f, seconds);
     }
 }
 
@@ -443,4 +455,42 @@ void AudioManager::updateFade(float deltaTime) {
             isFading_ = false;
         }
     }
-}
\ No newline at end of file
+}
+
+void AudioManager::beginTimeline() {
+    timeline_.clear();
+    recordedVolumes_.clear();
+    timelineTime_ = 0.0;
+    recordingTimeline_ = true;
+}
+
+std::vector<AudioTimelineEvent> AudioManager::endTimeline() {
+    recordingTimeline_ = false;
+    return std::move(timeline_);
+}
+
+void AudioManager::recordTimeline(AudioTimelineEvent::Type type, const std::string& name, const AudioHandle& handle,
+                                  float volume, double position) {
+    if (!recordingTimeline_) return;
+
+    // Every master or category change reapplies all volumes; only the
+    // channels whose final volume actually moved need an event.
+    if (type == AudioTimelineEvent::PLAY || type == AudioTimelineEvent::VOLUME) {
+        auto recorded = recordedVolumes_.find(name);
+        if (type == AudioTimelineEvent::VOLUME && recorded != recordedVolumes_.end() && recorded->second == volume) {
+            return;
+        }
+        recordedVolumes_[name] = volume;
+    }
+
+    AudioTimelineEvent event;
+    event.type = type;
+    event.timeSeconds = timelineTime_;
+    event.name = name;
+    event.path = handle.path;
+    event.volume = volume;
+    event.loop = handle.isLooping;
+    event.isSample = handle.type == AudioType::SOUND;
+    event.position = position;
+    timeline_.push_back(event);
+}
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+
+#include "system/AudioMixdown.h"
+#include "system/Logger.h"
+
+#define MIXDOWN_BLOCK_FRAMES 4096
+#define MIXDOWN_DECODE_FRAMES 4096
+
+// RIFF sizes are 32-bit; the data chunk has to fit behind the 36 header bytes.
+#define MIXDOWN_MAX_DATA_BYTES (UINT32_MAX - 36u)
+
+namespace AudioMixdown
+{
+    namespace {
+        struct Voice {
+            HSTREAM stream = 0;
+            std::string name;
+            float gain = 1.0f;
+            bool paused = false;
+            bool finished = false;
+            int channels = 2;
+
+            // Source frames per output frame, and the read position into
+            // buffer in source frames.
+            double step = 1.0;
+            double phase = 0.0;
+            std::vector<float> buffer;
+
+            ~Voice() {
+                if (stream) BASS_StreamFree(stream);
+            }
+
+            size_t frames() const { return buffer.size() / channels; }
+
+            // Decodes until frame index is buffered; false at the end.
+            bool fill(size_t index) {
+                while (frames() <= index && !finished) {
+                    size_t old = buffer.size();
+                    buffer.resize(old + (size_t)MIXDOWN_DECODE_FRAMES * channels);
+
+                    DWORD bytes = (DWORD)(MIXDOWN_DECODE_FRAMES * channels * sizeof(float));
+                    DWORD got = BASS_ChannelGetData(stream, buffer.data() + old, bytes | BASS_DATA_FLOAT);
+
+                    if (got == (DWORD)-1 || got == 0) {
+                        buffer.resize(old);
+                        finished = true;
+                    } else {
+                        buffer.resize(old + got / sizeof(float));
+                    }
+                }
+                return frames() > index;
+            }
+
+            // Linear resampling; fine for the small rate differences between
+            // assets and the export rate.
+            void mix(float* out, size_t count) {
+                if (paused || finished) return;
+
+                for (size_t i = 0; i < count; ++i) {
+                    size_t index = (size_t)phase;
+                    if (!fill(index)) break;
+
+                    bool hasNext = fill(index + 1);
+                    float t = (float)(phase - index);
+                    const float* a = buffer.data() + index * channels;
+                    const float* b = hasNext ? a + channels : a;
+
+                    float left = a[0] + (b[0] - a[0]) * t;
+                    float right = channels > 1 ? a[1] + (b[1] - a[1]) * t : left;
+
+                    out[i * 2] += left * gain;
+                    out[i * 2 + 1] += right * gain;
+                    phase += step;
+                }
+
+                size_t consumed = std::min((size_t)phase, frames());
+                buffer.erase(buffer.begin(), buffer.begin() + consumed * channels);
+                phase -= consumed;
+
+                if (finished && frames() == 0) {
+                    paused = true;
+                }
+            }
+
+            void seek(double seconds) {
+                BASS_ChannelSetPosition(stream, BASS_ChannelSeconds2Bytes(stream, seconds), BASS_POS_BYTE);
+                buffer.clear();
+                phase = 0.0;
+                finished = false;
+                paused = false;
+            }
+        };
+
+        std::unique_ptr<Voice> openVoice(const AudioTimelineEvent& event, int sampleRate) {
+            DWORD flags = BASS_STREAM_DECODE | BASS_SAMPLE_FLOAT | (event.loop ? BASS_SAMPLE_LOOP : 0);
+            HSTREAM stream = BASS_StreamCreateFile(FALSE, event.path.c_str(), 0, 0, flags);
+            if (!stream) {
+                GAME_LOG_ERROR("Mixdown failed to decode " + event.path + " (Error: " +
+                               std::to_string(BASS_ErrorGetCode()) + ")");
+                return nullptr;
+            }
+
+            BASS_CHANNELINFO info;
+            BASS_ChannelGetInfo(stream, &info);
+
+            auto voice = std::make_unique<Voice>();
+            voice->stream = stream;
+            voice->name = event.name;
+            voice->gain = event.volume;
+            voice->channels = std::max((int)info.chans, 1);
+            voice->step = (double)info.freq / sampleRate;
+            return voice;
+        }
+
+        void put16(FILE* file, uint16_t value) {
+            unsigned char bytes[2] = { (unsigned char)value, (unsigned char)(value >> 8) };
+            fwrite(bytes, 1, 2, file);
+        }
+
+        void put32(FILE* file, uint32_t value) {
+            unsigned char bytes[4] = { (unsigned char)value, (unsigned char)(value >> 8),
+                                       (unsigned char)(value >> 16), (unsigned char)(value >> 24) };
+            fwrite(bytes, 1, 4, file);
+        }
+
+        void writeWavHeader(FILE* file, int sampleRate, uint64_t frames) {
+            uint32_t dataSize = (uint32_t)(frames * 2 * sizeof(float));
+
+            fwrite("RIFF", 1, 4, file);
+            put32(file, 36 + dataSize);
+            fwrite("WAVEfmt ", 1, 8, file);
+            put32(file, 16);
+            put16(file, 3);
+            put16(file, 2);
+            put32(file, (uint32_t)sampleRate);
+            put32(file, (uint32_t)(sampleRate * 2 * sizeof(float)));
+            put16(file, 2 * sizeof(float));
+            put16(file, 32);
+            fwrite("data", 1, 4, file);
+            put32(file, dataSize);
+        }
+    }
+
+    bool render(const std::vector<AudioTimelineEvent>& events, double durationSeconds, const std::string& wavPath,
+                int sampleRate) {
+        uint64_t totalFrames = (uint64_t)std::llround(durationSeconds * sampleRate);
+        if (totalFrames > MIXDOWN_MAX_DATA_BYTES / (2 * sizeof(float))) {
+            GAME_LOG_ERROR("Mixdown of " + std::to_string(durationSeconds) + "s is too long for a WAV file: " + wavPath);
+            return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::path parent = std::filesystem::path(wavPath).parent_path();
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent, ec);
+        }
+
+        FILE* file = fopen(wavPath.c_str(), "wb");
+        if (!file) {
+            GAME_LOG_ERROR("Failed to write mixdown: " + wavPath);
+            return false;
+        }
+
+        writeWavHeader(file, sampleRate, totalFrames);
+
+        std::vector<std::unique_ptr<Voice>> voices;
+        std::vector<float> block((size_t)MIXDOWN_BLOCK_FRAMES * 2);
+        size_t nextEvent = 0;
+        uint64_t frame = 0;
+
+        while (frame < totalFrames) {
+            // Apply everything that happens at or before this frame, then
+            // mix up to the next event or the end of the block.
+            while (nextEvent < events.size() &&
+                   (uint64_t)std::llround(events[nextEvent].timeSeconds * sampleRate) <= frame) {
+                const AudioTimelineEvent& event = events[nextEvent++];
+
+                auto sameName = [&event](const std::unique_ptr<Voice>& voice) { return voice->name == event.name; };
+
+                switch (event.type) {
+                    case AudioTimelineEvent::PLAY: {
+                        // Streams restart on play; sample plays overlap.
+                        if (!event.isSample) {
+                            voices.erase(std::remove_if(voices.begin(), voices.end(), sameName), voices.end());
+                        }
+                        if (auto voice = openVoice(event, sampleRate)) {
+                            voices.push_back(std::move(voice));
+                        }
+                        break;
+                    }
+                    case AudioTimelineEvent::STOP:
+                        voices.erase(std::remove_if(voices.begin(), voices.end(), sameName), voices.end());
+                        break;
+                    default:
+                        for (auto& voice : voices) {
+                            if (voice->name != event.name) continue;
+
+                            if (event.type == AudioTimelineEvent::PAUSE) voice->paused = true;
+                            else if (event.type == AudioTimelineEvent::RESUME) voice->paused = false;
+                            else if (event.type == AudioTimelineEvent::SEEK) voice->seek(event.position);
+                            else if (event.type == AudioTimelineEvent::VOLUME) voice->gain = event.volume;
+                        }
+                        break;
+                }
+            }
+
+            uint64_t end = std::min(frame + MIXDOWN_BLOCK_FRAMES, totalFrames);
+            if (nextEvent < events.size()) {
+                uint64_t eventFrame = (uint64_t)std::llround(events[nextEvent].timeSeconds * sampleRate);
+                end = std::min(end, std::max(eventFrame, frame + 1));
+            }
+
+            size_t count = (size_t)(end - frame);
+            std::fill(block.begin(), block.begin() + count * 2, 0.0f);
+            for (auto& voice : voices) {
+                voice->mix(block.data(), count);
+            }
+
+            fwrite(block.data(), sizeof(float), count * 2, file);
+            frame = end;
+        }
+
+        bool ok = !ferror(file);
+        fclose(file);
+
+        if (ok) {
+            GAME_LOG_INFO("Mixed " + std::to_string(events.size()) + " audio events into " + wavPath);
+        } else {
+            GAME_LOG_ERROR("Failed to write mixdown: " + wavPath);
+        }
+        return ok;
+    }
+}
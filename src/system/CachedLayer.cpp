@@ -0,0 +1,95 @@
+#include "system/CachedLayer.h"
+#include "system/GLState.h"
+#include "system/RenderTargetPool.h"
+
+CachedLayer::CachedLayer(AppContext* appContext)
+    : appContext_(appContext) {
+}
+
+CachedLayer::~CachedLayer() {
+    release();
+}
+
+void CachedLayer::release() {
+    if (target_) {
+        appContext_->renderTargetPool->release(target_);
+        target_ = nullptr;
+    }
+    valid_ = false;
+}
+
+bool CachedLayer::ensureTarget() {
+    int width = (int)appContext_->renderWidth;
+    int height = (int)appContext_->renderHeight;
+
+    if (target_ && target_->width == width && target_->height == height) {
+        return true;
+    }
+
+    release();
+    target_ = appContext_->renderTargetPool->acquire(width, height);
+    return target_ != nullptr;
+}
+
+bool CachedLayer::begin() {
+    if (valid_ && target_ && target_->width == (int)appContext_->renderWidth &&
+        target_->height == (int)appContext_->renderHeight) {
+        return false;
+    }
+
+    if (!ensureTarget()) {
+        return false;
+    }
+
+    Renderer2D* renderer = appContext_->renderer2D;
+    renderer->flush();
+
+    GLState& gl = GLState::getInstance();
+    previousFramebuffer_ = gl.getBoundFramebuffer();
+    gl.bindFramebuffer(target_->framebuffer);
+
+    // The main target may be rendered at a reduced scale; layers always
+    // cover the full logical size.
+    glGetIntegerv(GL_VIEWPORT, previousViewport_);
+    glViewport(0, 0, target_->width, target_->height);
+
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // Accumulate alpha properly so the texture ends up premultiplied and
+    // composites like the original draws would have.
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    recording_ = true;
+    return true;
+}
+
+void CachedLayer::end() {
+    if (!recording_) return;
+
+    appContext_->renderer2D->flush();
+
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::getInstance().bindFramebuffer(previousFramebuffer_);
+    glViewport(previousViewport_[0], previousViewport_[1], previousViewport_[2], previousViewport_[3]);
+
+    recording_ = false;
+    valid_ = true;
+}
+
+void CachedLayer::composite(const Color& tint) {
+    if (!valid_ || !target_) return;
+
+    Renderer2D* renderer = appContext_->renderer2D;
+    renderer->flush();
+
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Render targets are stored bottom-up, so sample with v flipped.
+    Rect uv = { 0.0f, 1.0f, 1.0f, -1.0f };
+    renderer->drawTexture(target_->colorTexture, uv, 0.0f, 0.0f, appContext_->renderWidth, appContext_->renderHeight,
+                          Color(tint.r * tint.a, tint.g * tint.a, tint.b * tint.a, tint.a));
+    renderer->flush();
+
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <cmath>
+
+#include "system/DynamicResolution.h"
+#include "system/Logger.h"
+
+DynamicResolution::DynamicResolution(const DynamicResolutionConfig& config) {
+    setConfig(config);
+}
+
+void DynamicResolution::setConfig(const DynamicResolutionConfig& config) {
+    config_ = config;
+    config_.sampleFrames = std::max(config_.sampleFrames, 1);
+    config_.minScale = std::clamp(config_.minScale, 0.1f, 1.0f);
+    config_.maxScale = std::clamp(config_.maxScale, config_.minScale, 2.0f);
+
+    samples_.assign(config_.sampleFrames, 0.0);
+    sampleIndex_ = 0;
+    framesSinceChange_ = 0;
+    scale_ = snap(std::clamp(scale_, config_.minScale, config_.maxScale));
+}
+
+float DynamicResolution::snap(float scale) const {
+    if (config_.scaleStep > 0.0f) {
+        scale = std::round(scale / config_.scaleStep) * config_.scaleStep;
+    }
+    return std::clamp(scale, config_.minScale, config_.maxScale);
+}
+
+bool DynamicResolution::update(double cpuMs, double gpuMs) {
+    // Whichever side is slower bounds the frame.
+    samples_[sampleIndex_] = std::max(cpuMs, gpuMs);
+    sampleIndex_ = (sampleIndex_ + 1) % samples_.size();
+
+    if (++framesSinceChange_ < config_.sampleFrames) {
+        return false;
+    }
+
+    double total = 0.0;
+    for (double sample : samples_) {
+        total += sample;
+    }
+    averageMs_ = total / samples_.size();
+
+    if (averageMs_ <= 0.0) {
+        return false;
+    }
+
+    float scale = scale_;
+    if (averageMs_ > config_.targetFrameMs) {
+        // Fill cost goes with the pixel count, i.e. the square of the scale.
+        scale = scale_ * (float)std::sqrt(config_.targetFrameMs / averageMs_);
+        scale = std::min(snap(scale), scale_ - config_.scaleStep);
+    } else if (averageMs_ < config_.targetFrameMs * config_.upscaleHeadroom) {
+        scale = scale_ + config_.scaleStep;
+    }
+
+    scale = snap(scale);
+    if (std::fabs(scale - scale_) < 0.001f) {
+        return false;
+    }
+
+    GAME_LOG_DEBUG("Render scale " + std::to_string(scale_) + " -> " + std::to_string(scale) +
+                   " (avg " + std::to_string(averageMs_) + "ms, target " + std::to_string(config_.targetFrameMs) + "ms)");
+
+    scale_ = scale;
+    framesSinceChange_ = 0;
+    return true;
+}
@@ -0,0 +1,155 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#include "system/FrameCapture.h"
+#include "system/GLState.h"
+#include "system/Logger.h"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+namespace FrameCapture
+{
+    bool readPixels(const RenderContext* target, std::vector<unsigned char>& pixels) {
+        if (!target) return false;
+
+        GLState& gl = GLState::getInstance();
+        GLuint previous = gl.getBoundFramebuffer();
+        gl.bindFramebuffer(target->framebuffer);
+
+        size_t rowSize = (size_t)target->width * 4;
+        pixels.resize(rowSize * target->height);
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, target->width, target->height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+        gl.bindFramebuffer(previous);
+
+        // GL returns the bottom row first.
+        std::vector<unsigned char> row(rowSize);
+        for (int y = 0; y < target->height / 2; ++y) {
+            unsigned char* top = pixels.data() + rowSize * y;
+            unsigned char* bottom = pixels.data() + rowSize * (target->height - 1 - y);
+            std::memcpy(row.data(), top, rowSize);
+            std::memcpy(top, bottom, rowSize);
+            std::memcpy(bottom, row.data(), rowSize);
+        }
+
+        return true;
+    }
+
+    bool writePNG(const std::string& path, const unsigned char* rgba, int width, int height) {
+        std::error_code ec;
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent, ec);
+        }
+
+        if (!stbi_write_png(path.c_str(), width, height, 4, rgba, width * 4)) {
+            GAME_LOG_ERROR("Failed to write PNG: " + path);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool writeQOI(const std::string& path, const unsigned char* rgba, int width, int height) {
+        std::error_code ec;
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent, ec);
+        }
+
+        size_t pixelCount = (size_t)width * height;
+        std::vector<unsigned char> out;
+        out.reserve(14 + pixelCount * 5 + 8);
+
+        auto put32 = [&out](uint32_t value) {
+            out.push_back((unsigned char)(value >> 24));
+            out.push_back((unsigned char)(value >> 16));
+            out.push_back((unsigned char)(value >> 8));
+            out.push_back((unsigned char)value);
+        };
+
+        out.insert(out.end(), { 'q', 'o', 'i', 'f' });
+        put32((uint32_t)width);
+        put32((uint32_t)height);
+        out.push_back(4);
+        out.push_back(0);
+
+        unsigned char index[64][4] = {};
+        unsigned char previous[4] = { 0, 0, 0, 255 };
+        int run = 0;
+
+        for (size_t i = 0; i < pixelCount; ++i) {
+            const unsigned char* px = rgba + i * 4;
+
+            if (std::memcmp(px, previous, 4) == 0) {
+                run++;
+                if (run == 62 || i == pixelCount - 1) {
+                    out.push_back((unsigned char)(0xC0 | (run - 1)));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run > 0) {
+                out.push_back((unsigned char)(0xC0 | (run - 1)));
+                run = 0;
+            }
+
+            int hash = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+            if (std::memcmp(index[hash], px, 4) == 0) {
+                out.push_back((unsigned char)hash);
+            } else {
+                std::memcpy(index[hash], px, 4);
+
+                if (px[3] == previous[3]) {
+                    int dr = (signed char)(px[0] - previous[0]);
+                    int dg = (signed char)(px[1] - previous[1]);
+                    int db = (signed char)(px[2] - previous[2]);
+                    int drg = dr - dg;
+                    int dbg = db - dg;
+
+                    if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2) {
+                        out.push_back((unsigned char)(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+                    } else if (drg > -9 && drg < 8 && dg > -33 && dg < 32 && dbg > -9 && dbg < 8) {
+                        out.push_back((unsigned char)(0x80 | (dg + 32)));
+                        out.push_back((unsigned char)((drg + 8) << 4 | (dbg + 8)));
+                    } else {
+                        out.push_back(0xFE);
+                        out.insert(out.end(), px, px + 3);
+                    }
+                } else {
+                    out.push_back(0xFF);
+                    out.insert(out.end(), px, px + 4);
+                }
+            }
+
+            std::memcpy(previous, px, 4);
+        }
+
+        out.insert(out.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file || fwrite(out.data(), 1, out.size(), file) != out.size()) {
+            if (file) fclose(file);
+            GAME_LOG_ERROR("Failed to write QOI: " + path);
+            return false;
+        }
+
+        fclose(file);
+        return true;
+    }
+
+    bool savePNG(const RenderContext* target, const std::string& path) {
+        std::vector<unsigned char> pixels;
+        if (!readPixels(target, pixels)) {
+            return false;
+        }
+
+        return writePNG(path, pixels.data(), target->width, target->height);
+    }
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "system/FramePacer.h"
+
+// Never sleep closer to the deadline than this, even if sleeps have been
+// accurate so far.
+static const double MIN_SPIN_MS = 0.5;
+
+// The spin window never covers more than this share of the period, so even
+// a 1 kHz cap or a bad overshoot estimate leaves most of a frame asleep.
+static const double MAX_SPIN_FRACTION = 0.25;
+
+// Headroom added to the measured frame cost in late sampling mode.
+static const double LATE_SAMPLING_MARGIN_MS = 1.0;
+
+FramePacer::FramePacer(int framerateCap) {
+    intervals_.reserve(FRAME_PACER_HISTORY);
+    setFramerateCap(framerateCap);
+}
+
+void FramePacer::setFramerateCap(int framerateCap) {
+    framerateCap_ = framerateCap;
+    period_ = framerateCap > 0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / framerateCap))
+        : Clock::duration::zero();
+    started_ = false;
+}
+
+void FramePacer::waitUntil(Clock::time_point deadline) {
+    while (true) {
+        Clock::time_point now = Clock::now();
+        double remainingMs = std::chrono::duration<double, std::milli>(deadline - now).count();
+        if (remainingMs <= 0.0) return;
+
+        double spinMs = std::max(MIN_SPIN_MS, sleepOvershootMs_ * 1.5);
+        if (period_ != Clock::duration::zero()) {
+            spinMs = std::min(spinMs, std::chrono::duration<double, std::milli>(period_).count() * MAX_SPIN_FRACTION);
+        }
+        if (remainingMs <= spinMs) break;
+
+        auto request = std::chrono::duration<double, std::milli>(remainingMs - spinMs);
+        std::this_thread::sleep_for(request);
+
+        // Learn how late this OS wakes us up and keep that much spin time.
+        double sleptMs = std::chrono::duration<double, std::milli>(Clock::now() - now).count();
+        double overshootMs = std::max(sleptMs - request.count(), 0.0);
+        sleepOvershootMs_ = overshootMs > sleepOvershootMs_
+            ? overshootMs
+            : sleepOvershootMs_ * 0.95 + overshootMs * 0.05;
+    }
+
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::beginFrame() {
+    if (period_ != Clock::duration::zero() && started_ && lateSampling_) {
+        auto lead = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double, std::milli>(workMs_ + LATE_SAMPLING_MARGIN_MS));
+        waitUntil(nextSlot_ - std::min(lead, period_));
+    }
+
+    frameStart_ = Clock::now();
+    recordInterval(frameStart_);
+}
+
+void FramePacer::endFrame() {
+    Clock::time_point now = Clock::now();
+
+    double workMs = std::chrono::duration<double, std::milli>(now - frameStart_).count();
+    workMs_ = workMs_ > 0.0 ? workMs_ * 0.9 + workMs * 0.1 : workMs;
+
+    if (period_ == Clock::duration::zero()) return;
+
+    if (!started_) {
+        nextSlot_ = now;
+        started_ = true;
+    }
+
+    nextSlot_ += period_;
+
+    // After a hitch, start a new schedule instead of rushing through the
+    // missed slots.
+    if (now > nextSlot_ + period_) {
+        nextSlot_ = now + period_;
+    }
+
+    if (!lateSampling_) {
+        waitUntil(nextSlot_);
+    }
+}
+
+void FramePacer::recordInterval(Clock::time_point frameStart) {
+    if (lastFrameStart_ != Clock::time_point()) {
+        double intervalMs = std::chrono::duration<double, std::milli>(frameStart - lastFrameStart_).count();
+
+        if (intervals_.size() < FRAME_PACER_HISTORY) {
+            intervals_.push_back(intervalMs);
+        } else {
+            intervals_[intervalIndex_] = intervalMs;
+        }
+        intervalIndex_ = (intervalIndex_ + 1) % FRAME_PACER_HISTORY;
+    }
+    lastFrameStart_ = frameStart;
+
+    if (intervals_.empty()) return;
+
+    double total = 0.0;
+    for (double interval : intervals_) {
+        total += interval;
+    }
+    averageIntervalMs_ = total / intervals_.size();
+
+    // Measured against the cap when there is one, otherwise against the
+    // average so an uncapped loop still reports how uneven it is.
+    double targetMs = period_ != Clock::duration::zero()
+        ? std::chrono::duration<double, std::milli>(period_).count()
+        : averageIntervalMs_;
+
+    double sumSquares = 0.0;
+    maxDeviationMs_ = 0.0;
+    for (double interval : intervals_) {
+        double deviation = interval - targetMs;
+        sumSquares += deviation * deviation;
+        maxDeviationMs_ = std::max(maxDeviationMs_, std::fabs(deviation));
+    }
+    jitterMs_ = std::sqrt(sumSquares / intervals_.size());
+}
@@ -0,0 +1,187 @@
+#include <cstring>
+
+#include "system/GLState.h"
+#include "system/Logger.h"
+
+bool GLState::initialize() {
+    invalidate();
+
+    if (!projectionUBO_) {
+        glGenBuffers(1, &projectionUBO_);
+        glBindBuffer(GL_UNIFORM_BUFFER, projectionUBO_);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(glm::mat4), &projection_[0][0], GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, GL_STATE_PROJECTION_BINDING, projectionUBO_);
+        uniformBuffer_ = projectionUBO_;
+    }
+
+    return projectionUBO_ != 0;
+}
+
+void GLState::shutdown() {
+    if (projectionUBO_) {
+        deleteBuffer(projectionUBO_);
+        projectionUBO_ = 0;
+    }
+
+    uniformLocations_.clear();
+    invalidate();
+}
+
+void GLState::invalidate() {
+    // ~0u never matches a real object name, so the next bind of anything
+    // goes straight to the driver.
+    program_ = ~0u;
+    vao_ = ~0u;
+    arrayBuffer_ = ~0u;
+    uniformBuffer_ = ~0u;
+    activeUnit_ = ~0u;
+    framebuffer_ = ~0u;
+    for (GLuint& texture : textures_) {
+        texture = ~0u;
+    }
+}
+
+void GLState::useProgram(GLuint program) {
+    if (program_ != program) {
+        glUseProgram(program);
+        program_ = program;
+    }
+}
+
+void GLState::bindVertexArray(GLuint vao) {
+    if (vao_ != vao) {
+        glBindVertexArray(vao);
+        vao_ = vao;
+    }
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer) {
+    if (target == GL_ARRAY_BUFFER) {
+        if (arrayBuffer_ == buffer) return;
+        arrayBuffer_ = buffer;
+    } else if (target == GL_UNIFORM_BUFFER) {
+        if (uniformBuffer_ == buffer) return;
+        uniformBuffer_ = buffer;
+    }
+
+    // Element array bindings belong to the bound VAO, so they are not cached.
+    glBindBuffer(target, buffer);
+}
+
+void GLState::bindTexture(GLuint unit, GLuint texture) {
+    if (unit >= GL_STATE_MAX_TEXTURE_UNITS) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        activeUnit_ = unit;
+        return;
+    }
+
+    if (textures_[unit] == texture) return;
+
+    if (activeUnit_ != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        activeUnit_ = unit;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    textures_[unit] = texture;
+}
+
+void GLState::setActiveUnit(GLuint unit) {
+    if (activeUnit_ != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        activeUnit_ = unit;
+    }
+}
+
+void GLState::bindFramebuffer(GLuint framebuffer) {
+    if (framebuffer_ != framebuffer) {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        framebuffer_ = framebuffer;
+    }
+}
+
+GLuint GLState::getBoundFramebuffer() {
+    if (framebuffer_ == ~0u) {
+        GLint binding = 0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &binding);
+        framebuffer_ = (GLuint)binding;
+    }
+    return framebuffer_;
+}
+
+void GLState::deleteProgram(GLuint program) {
+    if (!program) return;
+
+    if (program_ == program) program_ = 0;
+    uniformLocations_.erase(program);
+    glDeleteProgram(program);
+}
+
+void GLState::deleteVertexArray(GLuint vao) {
+    if (!vao) return;
+
+    if (vao_ == vao) vao_ = 0;
+    glDeleteVertexArrays(1, &vao);
+}
+
+void GLState::deleteBuffer(GLuint buffer) {
+    if (!buffer) return;
+
+    if (arrayBuffer_ == buffer) arrayBuffer_ = 0;
+    if (uniformBuffer_ == buffer) uniformBuffer_ = 0;
+    glDeleteBuffers(1, &buffer);
+}
+
+void GLState::deleteTexture(GLuint texture) {
+    if (!texture) return;
+
+    for (GLuint& bound : textures_) {
+        if (bound == texture) bound = 0;
+    }
+    glDeleteTextures(1, &texture);
+}
+
+void GLState::deleteFramebuffer(GLuint framebuffer) {
+    if (!framebuffer) return;
+
+    if (framebuffer_ == framebuffer) framebuffer_ = 0;
+    glDeleteFramebuffers(1, &framebuffer);
+}
+
+GLint GLState::getUniformLocation(GLuint program, const std::string& name) {
+    auto& locations = uniformLocations_[program];
+
+    auto it = locations.find(name);
+    if (it != locations.end()) {
+        return it->second;
+    }
+
+    GLint location = glGetUniformLocation(program, name.c_str());
+    locations[name] = location;
+    return location;
+}
+
+void GLState::attachProjectionBlock(GLuint program) {
+    GLuint blockIndex = glGetUniformBlockIndex(program, "Projection");
+    if (blockIndex == GL_INVALID_INDEX) {
+        GAME_LOG_WARN("Shader program " + std::to_string(program) + " has no Projection uniform block");
+        return;
+    }
+
+    glUniformBlockBinding(program, blockIndex, GL_STATE_PROJECTION_BINDING);
+}
+
+void GLState::setProjection(const glm::mat4& projection) {
+    if (projectionValid_ && std::memcmp(&projection_[0][0], &projection[0][0], sizeof(glm::mat4)) == 0) {
+        return;
+    }
+
+    projection_ = projection;
+    projectionValid_ = true;
+
+    if (!projectionUBO_) return;
+
+    bindBuffer(GL_UNIFORM_BUFFER, projectionUBO_);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), &projection_[0][0]);
+}
@@ -0,0 +1,133 @@
+#include "system/GPUProfiler.h"
+#include "system/Logger.h"
+
+GPUProfiler::~GPUProfiler() {
+    shutdown();
+}
+
+bool GPUProfiler::initialize() {
+    GLint bits = 0;
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+
+    supported_ = bits > 0;
+    if (!supported_) {
+        GAME_LOG_WARN("GPU timestamp queries not supported, GPU profiler disabled");
+    }
+
+    return supported_;
+}
+
+void GPUProfiler::shutdown() {
+    for (auto& frame : frames_) {
+        if (!frame.queries.empty()) {
+            glDeleteQueries((GLsizei)frame.queries.size(), frame.queries.data());
+        }
+        frame.queries.clear();
+        frame.scopes.clear();
+        frame.usedQueries = 0;
+        frame.pending = false;
+    }
+
+    supported_ = false;
+}
+
+GLuint GPUProfiler::nextQuery(Frame& frame) {
+    if (frame.usedQueries == frame.queries.size()) {
+        size_t grow = frame.queries.empty() ? 16 : frame.queries.size();
+        frame.queries.resize(frame.queries.size() + grow);
+        glGenQueries((GLsizei)grow, frame.queries.data() + frame.usedQueries);
+    }
+
+    return frame.queries[frame.usedQueries++];
+}
+
+void GPUProfiler::beginFrame() {
+    if (!supported_) return;
+
+    Frame& frame = frames_[frameIndex_];
+
+    // This slot was last written GPU_PROFILER_FRAME_LATENCY frames ago.
+    if (frame.pending) {
+        GLint available = 0;
+        glGetQueryObjectiv(frame.frameEnd, GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (available) {
+            collect(frame);
+        } else {
+            droppedFrames_++;
+        }
+    }
+
+    frame.scopes.clear();
+    frame.usedQueries = 0;
+    frame.pending = false;
+    openScopes_.clear();
+
+    frame.frameStart = nextQuery(frame);
+    glQueryCounter(frame.frameStart, GL_TIMESTAMP);
+    inFrame_ = true;
+}
+
+void GPUProfiler::endFrame() {
+    if (!supported_ || !inFrame_) return;
+
+    while (!openScopes_.empty()) {
+        endScope();
+    }
+
+    Frame& frame = frames_[frameIndex_];
+    frame.frameEnd = nextQuery(frame);
+    glQueryCounter(frame.frameEnd, GL_TIMESTAMP);
+    frame.pending = true;
+
+    inFrame_ = false;
+    frameIndex_ = (frameIndex_ + 1) % GPU_PROFILER_FRAME_LATENCY;
+}
+
+void GPUProfiler::beginScope(const std::string& name) {
+    if (!supported_ || !inFrame_) return;
+
+    Frame& frame = frames_[frameIndex_];
+
+    Scope scope;
+    scope.name = name;
+    scope.depth = (int)openScopes_.size();
+    scope.startQuery = nextQuery(frame);
+    scope.endQuery = 0;
+    glQueryCounter(scope.startQuery, GL_TIMESTAMP);
+
+    openScopes_.push_back(frame.scopes.size());
+    frame.scopes.push_back(scope);
+}
+
+void GPUProfiler::endScope() {
+    if (!supported_ || !inFrame_ || openScopes_.empty()) return;
+
+    Frame& frame = frames_[frameIndex_];
+    Scope& scope = frame.scopes[openScopes_.back()];
+    openScopes_.pop_back();
+
+    scope.endQuery = nextQuery(frame);
+    glQueryCounter(scope.endQuery, GL_TIMESTAMP);
+}
+
+void GPUProfiler::collect(Frame& frame) {
+    GLuint64 start = 0, end = 0;
+    glGetQueryObjectui64v(frame.frameStart, GL_QUERY_RESULT, &start);
+    glGetQueryObjectui64v(frame.frameEnd, GL_QUERY_RESULT, &end);
+    frameMilliseconds_ = (double)(end - start) / 1000000.0;
+
+    results_.clear();
+    for (const auto& scope : frame.scopes) {
+        if (!scope.endQuery) continue;
+
+        glGetQueryObjectui64v(scope.startQuery, GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(scope.endQuery, GL_QUERY_RESULT, &end);
+
+        GPUScopeResult result;
+        result.name = scope.name;
+        result.depth = scope.depth;
+        result.milliseconds = (double)(end - start) / 1000000.0;
+        results_.push_back(result);
+    }
+}
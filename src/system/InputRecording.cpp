@@ -0,0 +1,84 @@
+#include <cstdio>
+
+#include "system/InputRecording.h"
+#include "system/Logger.h"
+
+#define INPUT_RECORDING_MAGIC "aethel-input 1"
+
+void InputRecording::record(const TimedInputEvent& event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.push_back(event);
+}
+
+bool InputRecording::save(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        GAME_LOG_ERROR("Failed to write input recording: " + path);
+        return false;
+    }
+
+    fprintf(file, "%s\n", INPUT_RECORDING_MAGIC);
+    for (const TimedInputEvent& event : events_) {
+        fprintf(file, "%d %.17g %d %d %d %.17g %.17g %d\n", (int)event.type, event.timeSeconds, event.key,
+                event.scancode, event.mods, event.mouseX, event.mouseY, event.button);
+    }
+
+    fclose(file);
+    GAME_LOG_INFO("Saved " + std::to_string(events_.size()) + " input events to " + path);
+    return true;
+}
+
+bool InputRecording::load(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    FILE* file = fopen(path.c_str(), "r");
+    if (!file) {
+        GAME_LOG_ERROR("Failed to open input recording: " + path);
+        return false;
+    }
+
+    char header[64] = {};
+    if (!fgets(header, sizeof(header), file) || std::string(header).rfind(INPUT_RECORDING_MAGIC, 0) != 0) {
+        GAME_LOG_ERROR("Not an input recording: " + path);
+        fclose(file);
+        return false;
+    }
+
+    events_.clear();
+    cursor_ = 0;
+
+    TimedInputEvent event{};
+    int type;
+    while (fscanf(file, "%d %lf %d %d %d %lf %lf %d", &type, &event.timeSeconds, &event.key, &event.scancode,
+                  &event.mods, &event.mouseX, &event.mouseY, &event.button) == 8) {
+        event.type = (TimedInputEvent::Type)type;
+        events_.push_back(event);
+    }
+
+    fclose(file);
+    GAME_LOG_INFO("Loaded " + std::to_string(events_.size()) + " input events from " + path);
+    return true;
+}
+
+bool InputRecording::next(double untilSeconds, TimedInputEvent& event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (cursor_ >= events_.size() || events_[cursor_].timeSeconds > untilSeconds) {
+        return false;
+    }
+
+    event = events_[cursor_++];
+    return true;
+}
+
+size_t InputRecording::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_.size();
+}
+
+double InputRecording::getDuration() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_.empty() ? 0.0 : events_.back().timeSeconds;
+}
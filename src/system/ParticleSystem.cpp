@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <cmath>
+
+#include "system/ParticleSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLES_USE_SSE 1
+#endif
+
+ParticleSystem::ParticleSystem(size_t capacity)
+    : capacity_(capacity), rng_(std::random_device{}()) {
+    x_.resize(capacity);
+    y_.resize(capacity);
+    vx_.resize(capacity);
+    vy_.resize(capacity);
+    life_.resize(capacity);
+    invLifetime_.resize(capacity);
+    sizeStart_.resize(capacity);
+    sizeEnd_.resize(capacity);
+    r_.resize(capacity);
+    g_.resize(capacity);
+    b_.resize(capacity);
+    a_.resize(capacity);
+    fade_.resize(capacity);
+}
+
+void ParticleSystem::setTexture(GLuint textureID) {
+    region_ = TextureRegion();
+    region_.textureID = textureID;
+}
+
+size_t ParticleSystem::emit(float x, float y, size_t count, const ParticleEmitterConfig& config) {
+    count = std::min(count, capacity_ - count_);
+
+    std::uniform_real_distribution<float> angle(config.angleMin, config.angleMax);
+    std::uniform_real_distribution<float> speed(config.speedMin, config.speedMax);
+    std::uniform_real_distribution<float> life(std::max(config.lifeMin, 0.001f), std::max(config.lifeMax, config.lifeMin));
+
+    for (size_t n = 0; n < count; ++n) {
+        size_t i = count_++;
+        float a = angle(rng_);
+        float s = speed(rng_);
+        float l = life(rng_);
+
+        x_[i] = x;
+        y_[i] = y;
+        vx_[i] = std::cos(a) * s;
+        vy_[i] = std::sin(a) * s;
+        life_[i] = l;
+        invLifetime_[i] = 1.0f / l;
+        sizeStart_[i] = config.sizeStart;
+        sizeEnd_[i] = config.sizeEnd;
+        r_[i] = config.color.r;
+        g_[i] = config.color.g;
+        b_[i] = config.color.b;
+        a_[i] = config.color.a;
+        fade_[i] = config.fadeOut ? 1 : 0;
+    }
+
+    return count;
+}
+
+void ParticleSystem::update(float deltaTime) {
+    if (count_ == 0 || deltaTime <= 0.0f) return;
+
+    integrate(deltaTime);
+    removeDead();
+}
+
+void ParticleSystem::integrate(float deltaTime) {
+    float damping = std::max(1.0f - drag_ * deltaTime, 0.0f);
+    float gx = gravityX_ * deltaTime;
+    float gy = gravityY_ * deltaTime;
+
+    float* __restrict x = x_.data();
+    float* __restrict y = y_.data();
+    float* __restrict vx = vx_.data();
+    float* __restrict vy = vy_.data();
+    float* __restrict life = life_.data();
+
+    size_t i = 0;
+
+#ifdef PARTICLES_USE_SSE
+    __m128 dt4 = _mm_set1_ps(deltaTime);
+    __m128 damping4 = _mm_set1_ps(damping);
+    __m128 gx4 = _mm_set1_ps(gx);
+    __m128 gy4 = _mm_set1_ps(gy);
+
+    for (; i + 4 <= count_; i += 4) {
+        __m128 nvx = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vx + i), damping4), gx4);
+        __m128 nvy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vy + i), damping4), gy4);
+        _mm_storeu_ps(vx + i, nvx);
+        _mm_storeu_ps(vy + i, nvy);
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(nvx, dt4)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(nvy, dt4)));
+        _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), dt4));
+    }
+#endif
+
+    for (; i < count_; ++i) {
+        vx[i] = vx[i] * damping + gx;
+        vy[i] = vy[i] * damping + gy;
+        x[i] += vx[i] * deltaTime;
+        y[i] += vy[i] * deltaTime;
+        life[i] -= deltaTime;
+    }
+}
+
+void ParticleSystem::removeDead() {
+    size_t i = 0;
+    while (i < count_) {
+        if (life_[i] > 0.0f) {
+            i++;
+            continue;
+        }
+
+        // Swap-remove: order does not matter for additive-looking effects,
+        // and it keeps the live range contiguous without shifting.
+        size_t last = --count_;
+        x_[i] = x_[last];
+        y_[i] = y_[last];
+        vx_[i] = vx_[last];
+        vy_[i] = vy_[last];
+        life_[i] = life_[last];
+        invLifetime_[i] = invLifetime_[last];
+        sizeStart_[i] = sizeStart_[last];
+        sizeEnd_[i] = sizeEnd_[last];
+        r_[i] = r_[last];
+        g_[i] = g_[last];
+        b_[i] = b_[last];
+        a_[i] = a_[last];
+        fade_[i] = fade_[last];
+    }
+}
+
+void ParticleSystem::render(Renderer2D* renderer) const {
+    if (count_ == 0) return;
+
+    float u0 = region_.u0, v0 = region_.v0;
+    float u1 = region_.u1, v1 = region_.v1;
+
+    renderer->beginBatch();
+
+    size_t done = 0;
+    while (done < count_) {
+        BatchVertex* out;
+        size_t n = renderer->allocateQuads(region_.textureID, count_ - done, out);
+        if (n == 0) break;
+
+        for (size_t k = 0; k < n; ++k) {
+            size_t i = done + k;
+
+            // 1 at birth, 0 at death.
+            float remaining = std::clamp(life_[i] * invLifetime_[i], 0.0f, 1.0f);
+            float half = (sizeEnd_[i] + (sizeStart_[i] - sizeEnd_[i]) * remaining) * 0.5f;
+            float alpha = fade_[i] ? a_[i] * remaining : a_[i];
+
+            float left = x_[i] - half, right = x_[i] + half;
+            float top = y_[i] - half, bottom = y_[i] + half;
+            float r = r_[i], g = g_[i], b = b_[i];
+
+            out[0] = { left, top,     u0, v0, r, g, b, alpha };
+            out[1] = { right, top,    u1, v0, r, g, b, alpha };
+            out[2] = { right, bottom, u1, v1, r, g, b, alpha };
+            out[3] = { left, bottom,  u0, v1, r, g, b, alpha };
+            out += 4;
+        }
+
+        done += n;
+    }
+
+    renderer->endBatch();
+}
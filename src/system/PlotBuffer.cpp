@@ -0,0 +1,69 @@
+#include <algorithm>
+
+#include "system/PlotBuffer.h"
+#include "system/GLState.h"
+
+PlotBuffer::~PlotBuffer() {
+    GLState& gl = GLState::getInstance();
+    gl.deleteTexture(texture_);
+    gl.deleteBuffer(buffer_);
+}
+
+void PlotBuffer::setPoints(const glm::vec2* points, size_t count) {
+    if (!points) count = 0;
+
+    if (count > 0) {
+        glm::vec2 lo = points[0];
+        glm::vec2 hi = points[0];
+        for (size_t i = 1; i < count; ++i) {
+            lo = glm::min(lo, points[i]);
+            hi = glm::max(hi, points[i]);
+        }
+        bounds_ = { lo.x, lo.y, hi.x - lo.x, hi.y - lo.y };
+    } else {
+        bounds_ = { 0.0f, 0.0f, 0.0f, 0.0f };
+    }
+
+    upload(points, count);
+}
+
+void PlotBuffer::setPoints(const std::vector<glm::vec2>& points) {
+    setPoints(points.data(), points.size());
+}
+
+void PlotBuffer::setValues(const float* values, size_t count) {
+    std::vector<glm::vec2> points(values ? count : 0);
+    for (size_t i = 0; i < points.size(); ++i) {
+        points[i] = glm::vec2((float)i, values[i]);
+    }
+    setPoints(points);
+}
+
+void PlotBuffer::upload(const glm::vec2* points, size_t count) {
+    GLState& gl = GLState::getInstance();
+
+    if (buffer_ == 0) {
+        glGenBuffers(1, &buffer_);
+        glGenTextures(1, &texture_);
+    }
+
+    gl.bindBuffer(GL_TEXTURE_BUFFER, buffer_);
+
+    // Reallocate only to grow; smaller updates reuse the storage.
+    if (count > capacity_ || capacity_ == 0) {
+        capacity_ = std::max(count, (size_t)1);
+        glBufferData(GL_TEXTURE_BUFFER, capacity_ * sizeof(glm::vec2), nullptr, GL_STATIC_DRAW);
+
+        // The buffer texture has to be re-attached to the new storage.
+        glBindTexture(GL_TEXTURE_BUFFER, texture_);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, buffer_);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+
+    if (count > 0) {
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, count * sizeof(glm::vec2), points);
+    }
+
+    gl.bindBuffer(GL_TEXTURE_BUFFER, 0);
+    count_ = count;
+}
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <vector>
+
+#include "system/PostProcess.h"
+#include "system/RenderTargetPool.h"
+#include "system/Renderer2D.h"
+#include "system/GLState.h"
+#include "system/Logger.h"
+#include "system/ShaderCache.h"
+
+static const char* fullscreenVertexShaderSource = R"(
+#version 330 core
+out vec2 TexCoord;
+void main() {
+    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    TexCoord = pos;
+    gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+static const char* kawaseDownFragmentShaderSource = R"(
+#version 330 core
+in vec2 TexCoord;
+out vec4 FragColor;
+uniform sampler2D source;
+uniform vec2 texelSize;
+uniform float offset;
+void main() {
+    vec2 o = texelSize * offset;
+    vec4 sum = texture(source, TexCoord) * 4.0;
+    sum += texture(source, TexCoord - o);
+    sum += texture(source, TexCoord + o);
+    sum += texture(source, TexCoord + vec2(o.x, -o.y));
+    sum += texture(source, TexCoord - vec2(o.x, -o.y));
+    FragColor = sum / 8.0;
+}
+)";
+
+static const char* kawaseUpFragmentShaderSource = R"(
+#version 330 core
+in vec2 TexCoord;
+out vec4 FragColor;
+uniform sampler2D source;
+uniform vec2 texelSize;
+uniform float offset;
+void main() {
+    vec2 o = texelSize * 0.5 * offset;
+    vec4 sum = texture(source, TexCoord + vec2(-o.x * 2.0, 0.0));
+    sum += texture(source, TexCoord + vec2(-o.x, o.y)) * 2.0;
+    sum += texture(source, TexCoord + vec2(0.0, o.y * 2.0));
+    sum += texture(source, TexCoord + vec2(o.x, o.y)) * 2.0;
+    sum += texture(source, TexCoord + vec2(o.x * 2.0, 0.0));
+    sum += texture(source, TexCoord + vec2(o.x, -o.y)) * 2.0;
+    sum += texture(source, TexCoord + vec2(0.0, -o.y * 2.0));
+    sum += texture(source, TexCoord + vec2(-o.x, -o.y)) * 2.0;
+    FragColor = sum / 12.0;
+}
+)";
+
+PostProcess::PostProcess(RenderTargetPool* pool)
+    : pool_(pool) {
+}
+
+PostProcess::~PostProcess() {
+    shutdown();
+}
+
+bool PostProcess::initialize() {
+    // Core profile wants a VAO bound even though the triangle comes from
+    // gl_VertexID alone.
+    glGenVertexArrays(1, &emptyVAO_);
+
+    downsampleProgram_ = createEffect(kawaseDownFragmentShaderSource);
+    upsampleProgram_ = createEffect(kawaseUpFragmentShaderSource);
+
+    return downsampleProgram_ && upsampleProgram_;
+}
+
+void PostProcess::shutdown() {
+    GLState& gl = GLState::getInstance();
+    gl.deleteProgram(downsampleProgram_);
+    gl.deleteProgram(upsampleProgram_);
+    gl.deleteVertexArray(emptyVAO_);
+    downsampleProgram_ = 0;
+    upsampleProgram_ = 0;
+    emptyVAO_ = 0;
+}
+
+GLuint PostProcess::createEffect(const char* fragmentSource) {
+    GLuint program = ShaderCache::getInstance().buildProgram("Post-process", fullscreenVertexShaderSource,
+                                                             fragmentSource);
+    if (!program) return 0;
+
+    GLState& gl = GLState::getInstance();
+    gl.useProgram(program);
+    glUniform1i(gl.getUniformLocation(program, "source"), 0);
+
+    return program;
+}
+
+void PostProcess::destroyEffect(GLuint effect) {
+    GLState::getInstance().deleteProgram(effect);
+}
+
+void PostProcess::runPass(GLuint program, GLuint sourceTexture, int sourceWidth, int sourceHeight,
+                          RenderContext* target, float offset) {
+    GLState& gl = GLState::getInstance();
+    gl.bindFramebuffer(target->framebuffer);
+    glViewport(0, 0, target->width, target->height);
+
+    gl.useProgram(program);
+    glUniform2f(gl.getUniformLocation(program, "texelSize"), 1.0f / sourceWidth, 1.0f / sourceHeight);
+    glUniform1f(gl.getUniformLocation(program, "offset"), offset);
+
+    gl.bindTexture(0, sourceTexture);
+    gl.bindVertexArray(emptyVAO_);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+RenderContext* PostProcess::apply(GLuint effect, GLuint sourceTexture, int sourceWidth, int sourceHeight,
+                                  int targetWidth, int targetHeight) {
+    if (!effect || !sourceTexture) return nullptr;
+
+    RenderContext* target = pool_->acquire(targetWidth, targetHeight);
+    if (!target) return nullptr;
+
+    GLState& gl = GLState::getInstance();
+    GLuint previousFramebuffer = gl.getBoundFramebuffer();
+    GLint previousViewport[4];
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+    glDisable(GL_BLEND);
+
+    runPass(effect, sourceTexture, sourceWidth, sourceHeight, target, 1.0f);
+
+    glEnable(GL_BLEND);
+    gl.bindFramebuffer(previousFramebuffer);
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+
+    return target;
+}
+
+RenderContext* PostProcess::blur(GLuint sourceTexture, int width, int height, int iterations, float offset) {
+    if (!sourceTexture || width <= 1 || height <= 1) return nullptr;
+
+    iterations = std::clamp(iterations, 1, 8);
+
+    std::vector<RenderContext*> levels;
+    int levelWidth = width;
+    int levelHeight = height;
+    for (int i = 0; i < iterations; ++i) {
+        levelWidth = std::max(levelWidth / 2, 1);
+        levelHeight = std::max(levelHeight / 2, 1);
+
+        RenderContext* level = pool_->acquire(levelWidth, levelHeight);
+        if (!level) break;
+        levels.push_back(level);
+    }
+
+    if (levels.empty()) return nullptr;
+
+    GLState& gl = GLState::getInstance();
+    GLuint previousFramebuffer = gl.getBoundFramebuffer();
+    GLint previousViewport[4];
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+    glDisable(GL_BLEND);
+
+    runPass(downsampleProgram_, sourceTexture, width, height, levels[0], offset);
+    for (size_t i = 1; i < levels.size(); ++i) {
+        runPass(downsampleProgram_, levels[i - 1]->colorTexture, levels[i - 1]->width, levels[i - 1]->height,
+                levels[i], offset);
+    }
+
+    // Back up into the same targets; each one's downsampled contents have
+    // already been consumed by the level below it.
+    for (size_t i = levels.size() - 1; i > 0; --i) {
+        runPass(upsampleProgram_, levels[i]->colorTexture, levels[i]->width, levels[i]->height,
+                levels[i - 1], offset);
+        pool_->release(levels[i]);
+    }
+
+    glEnable(GL_BLEND);
+    gl.bindFramebuffer(previousFramebuffer);
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+
+    return levels[0];
+}
+
+CachedBlur::CachedBlur(AppContext* appContext, int iterations, float offset)
+    : appContext_(appContext), iterations_(iterations), offset_(offset) {
+}
+
+CachedBlur::~CachedBlur() {
+    invalidate();
+}
+
+void CachedBlur::invalidate() {
+    if (result_) {
+        appContext_->renderTargetPool->release(result_);
+        result_ = nullptr;
+    }
+    sourceTexture_ = 0;
+}
+
+void CachedBlur::setIterations(int iterations) {
+    if (iterations != iterations_) {
+        iterations_ = iterations;
+        invalidate();
+    }
+}
+
+GLuint CachedBlur::get(GLuint sourceTexture, int width, int height) {
+    if (result_ && sourceTexture == sourceTexture_ && width == sourceWidth_ && height == sourceHeight_) {
+        return result_->colorTexture;
+    }
+
+    invalidate();
+
+    // Whatever is batched has to be drawn before framebuffers change.
+    appContext_->renderer2D->flush();
+
+    result_ = appContext_->postProcess->blur(sourceTexture, width, height, iterations_, offset_);
+    if (!result_) return 0;
+
+    sourceTexture_ = sourceTexture;
+    sourceWidth_ = width;
+    sourceHeight_ = height;
+    return result_->colorTexture;
+}
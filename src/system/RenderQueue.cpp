@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cmath>
+
+#include "system/RenderQueue.h"
+
+#define RENDER_SHADER_BATCH 0
+#define RENDER_SHADER_SHAPE 1
+
+uint64_t makeRenderSortKey(uint8_t layer, uint8_t shader, GLuint textureID, float depth) {
+    float clamped = std::clamp(depth, 0.0f, 1.0f);
+    uint64_t depthBits = (uint64_t)std::lround(clamped * 65535.0f);
+
+    return ((uint64_t)layer << 56) |
+           (depthBits << 40) |
+           ((uint64_t)(shader & 0xF) << 36) |
+           ((uint64_t)(textureID & 0xFFFFF) << 16);
+}
+
+void RenderCommandBuffer::drawRect(uint8_t layer, float depth, float x, float y, float width, float height, const Color& color) {
+    RenderCommand command;
+    command.sortKey = makeRenderSortKey(layer, RENDER_SHADER_BATCH, 0, depth);
+    command.type = RenderCommandType::RECT;
+    command.textureID = 0;
+    command.x = x;
+    command.y = y;
+    command.width = width;
+    command.height = height;
+    command.u0 = command.v0 = command.u1 = command.v1 = 0.0f;
+    command.color = color;
+    command.param = 0.0f;
+    commands_.push_back(command);
+}
+
+void RenderCommandBuffer::drawLine(uint8_t layer, float depth, float x1, float y1, float x2, float y2, float thickness, const Color& color) {
+    RenderCommand command;
+    command.sortKey = makeRenderSortKey(layer, RENDER_SHADER_BATCH, 0, depth);
+    command.type = RenderCommandType::LINE;
+    command.textureID = 0;
+    command.x = x1;
+    command.y = y1;
+    command.width = x2;
+    command.height = y2;
+    command.u0 = command.v0 = command.u1 = command.v1 = 0.0f;
+    command.color = color;
+    command.param = thickness;
+    commands_.push_back(command);
+}
+
+void RenderCommandBuffer::drawCircle(uint8_t layer, float depth, float x, float y, float radius, const Color& color) {
+    RenderCommand command;
+    command.sortKey = makeRenderSortKey(layer, RENDER_SHADER_SHAPE, 0, depth);
+    command.type = RenderCommandType::CIRCLE;
+    command.textureID = 0;
+    command.x = x;
+    command.y = y;
+    command.width = radius;
+    command.height = radius;
+    command.u0 = command.v0 = command.u1 = command.v1 = 0.0f;
+    command.color = color;
+    command.param = 0.0f;
+    commands_.push_back(command);
+}
+
+void RenderCommandBuffer::drawTexture(uint8_t layer, float depth, GLuint textureID, float x, float y, float width, float height, const Color& tint) {
+    TextureRegion region;
+    region.textureID = textureID;
+    drawTexture(layer, depth, region, x, y, width, height, tint);
+}
+
+void RenderCommandBuffer::drawTexture(uint8_t layer, float depth, const TextureRegion& region, float x, float y, float width, float height, const Color& tint) {
+    RenderCommand command;
+    command.sortKey = makeRenderSortKey(layer, RENDER_SHADER_BATCH, region.textureID, depth);
+    command.type = RenderCommandType::TEXTURE;
+    command.textureID = region.textureID;
+    command.x = x;
+    command.y = y;
+    command.width = width;
+    command.height = height;
+    command.u0 = region.u0;
+    command.v0 = region.v0;
+    command.u1 = region.u1;
+    command.v1 = region.v1;
+    command.color = tint;
+    command.param = 0.0f;
+    commands_.push_back(command);
+}
+
+void RenderQueue::submit(RenderCommandBuffer& buffer) {
+    const auto& commands = buffer.getCommands();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.insert(pending_.end(), commands.begin(), commands.end());
+    buffer.clear();
+}
+
+void RenderQueue::execute(Renderer2D* renderer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    lastCommandCount_ = pending_.size();
+    if (pending_.empty()) return;
+
+    // Sort indices rather than the fat command structs; ties keep their
+    // submission order.
+    order_.resize(pending_.size());
+    for (uint32_t i = 0; i < (uint32_t)order_.size(); ++i) {
+        order_[i] = i;
+    }
+
+    std::sort(order_.begin(), order_.end(), [this](uint32_t a, uint32_t b) {
+        uint64_t keyA = pending_[a].sortKey;
+        uint64_t keyB = pending_[b].sortKey;
+        return keyA != keyB ? keyA < keyB : a < b;
+    });
+
+    renderer->beginBatch();
+
+    for (uint32_t index : order_) {
+        const RenderCommand& command = pending_[index];
+
+        switch (command.type) {
+            case RenderCommandType::RECT:
+                renderer->drawRect(command.x, command.y, command.width, command.height, command.color);
+                break;
+            case RenderCommandType::LINE:
+                renderer->drawLine(command.x, command.y, command.width, command.height, command.param, command.color);
+                break;
+            case RenderCommandType::CIRCLE:
+                renderer->drawCircle(command.x, command.y, command.width, command.color);
+                break;
+            case RenderCommandType::TEXTURE: {
+                Rect uv = { command.u0, command.v0, command.u1 - command.u0, command.v1 - command.v0 };
+                renderer->drawTexture(command.textureID, uv, command.x, command.y, command.width, command.height, command.color);
+                break;
+            }
+        }
+    }
+
+    renderer->endBatch();
+    pending_.clear();
+}
@@ -0,0 +1,199 @@
+#include "system/RenderTargetPool.h"
+#include "system/GLState.h"
+#include "system/Logger.h"
+#include "system/ShaderCache.h"
+
+static const char* blitVertexShaderSource = R"(
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoord;
+out vec2 TexCoord;
+void main() {
+    gl_Position = vec4(aPos, 0.0, 1.0);
+    TexCoord = aTexCoord;
+}
+)";
+
+static const char* blitFragmentShaderSource = R"(
+#version 330 core
+in vec2 TexCoord;
+out vec4 FragColor;
+uniform sampler2D screenTexture;
+void main() {
+    FragColor = texture(screenTexture, TexCoord);
+}
+)";
+
+RenderTargetPool::~RenderTargetPool() {
+    shutdown();
+}
+
+bool RenderTargetPool::initialize() {
+    GLState& gl = GLState::getInstance();
+
+    blitProgram_ = ShaderCache::getInstance().buildProgram("Blit", blitVertexShaderSource, blitFragmentShaderSource);
+    if (!blitProgram_) {
+        return false;
+    }
+
+    gl.useProgram(blitProgram_);
+    glUniform1i(gl.getUniformLocation(blitProgram_, "screenTexture"), 0);
+
+    float quadVertices[] = {
+        -1.0f,  1.0f,  0.0f, 1.0f,
+        -1.0f, -1.0f,  0.0f, 0.0f,
+         1.0f, -1.0f,  1.0f, 0.0f,
+
+        -1.0f,  1.0f,  0.0f, 1.0f,
+         1.0f, -1.0f,  1.0f, 0.0f,
+         1.0f,  1.0f,  1.0f, 1.0f
+    };
+
+    glGenVertexArrays(1, &quadVAO_);
+    glGenBuffers(1, &quadVBO_);
+    gl.bindVertexArray(quadVAO_);
+    gl.bindBuffer(GL_ARRAY_BUFFER, quadVBO_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    gl.bindVertexArray(0);
+
+    return true;
+}
+
+void RenderTargetPool::shutdown() {
+    trim();
+
+    if (activeCount_ > 0) {
+        GAME_LOG_WARN(std::to_string(activeCount_) + " render targets still acquired at shutdown");
+    }
+
+    GLState& gl = GLState::getInstance();
+    gl.deleteVertexArray(quadVAO_);
+    gl.deleteBuffer(quadVBO_);
+    gl.deleteProgram(blitProgram_);
+    quadVAO_ = 0;
+    quadVBO_ = 0;
+    blitProgram_ = 0;
+}
+
+RenderContext* RenderTargetPool::acquire(int width, int height, GLenum format) {
+    if (width <= 0 || height <= 0) {
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < free_.size(); ++i) {
+        RenderContext* target = free_[i];
+        if (target->width == width && target->height == height && target->format == format) {
+            free_.erase(free_.begin() + i);
+            freeBytes_ -= getTargetBytes(target);
+            activeCount_++;
+            return target;
+        }
+    }
+
+    RenderContext* target = create(width, height, format);
+    if (target) {
+        activeCount_++;
+    }
+    return target;
+}
+
+void RenderTargetPool::release(RenderContext* target) {
+    if (!target) return;
+
+    if (activeCount_ > 0) {
+        activeCount_--;
+    }
+
+    // Most recently released last, so the oldest goes first when full.
+    free_.push_back(target);
+    freeBytes_ += getTargetBytes(target);
+
+    while (free_.size() > RENDER_TARGET_POOL_MAX_FREE ||
+           (free_.size() > 1 && freeBytes_ > RENDER_TARGET_POOL_FREE_BUDGET)) {
+        freeBytes_ -= getTargetBytes(free_.front());
+        destroy(free_.front());
+        free_.erase(free_.begin());
+    }
+}
+
+void RenderTargetPool::discard(RenderContext* target) {
+    if (!target) return;
+
+    if (activeCount_ > 0) {
+        activeCount_--;
+    }
+    destroy(target);
+}
+
+void RenderTargetPool::trim() {
+    for (RenderContext* target : free_) {
+        destroy(target);
+    }
+    free_.clear();
+    freeBytes_ = 0;
+}
+
+size_t RenderTargetPool::getTargetBytes(const RenderContext* target) {
+    size_t bytesPerPixel = 4;
+    if (target->format == GL_RGBA16F) {
+        bytesPerPixel = 8;
+    } else if (target->format == GL_RGBA32F) {
+        bytesPerPixel = 16;
+    }
+    return (size_t)target->width * target->height * bytesPerPixel;
+}
+
+void RenderTargetPool::blit(const RenderContext* target) {
+    if (!target || !blitProgram_) return;
+
+    GLState& gl = GLState::getInstance();
+    gl.useProgram(blitProgram_);
+    gl.bindVertexArray(quadVAO_);
+    gl.bindTexture(0, target->colorTexture);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+RenderContext* RenderTargetPool::create(int width, int height, GLenum format) {
+    RenderContext* ctx = new RenderContext();
+    ctx->width = width;
+    ctx->height = height;
+    ctx->format = format;
+
+    GLState& gl = GLState::getInstance();
+    GLuint previous = gl.getBoundFramebuffer();
+
+    glGenFramebuffers(1, &ctx->framebuffer);
+    gl.bindFramebuffer(ctx->framebuffer);
+
+    glGenTextures(1, &ctx->colorTexture);
+    gl.bindTexture(0, ctx->colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, ctx->colorTexture, 0);
+
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    gl.bindFramebuffer(previous);
+
+    if (!complete) {
+        GAME_LOG_ERROR("Framebuffer is not complete! (" + std::to_string(width) + "x" + std::to_string(height) + ")");
+        destroy(ctx);
+        return nullptr;
+    }
+
+    GAME_LOG_DEBUG("Created render target " + std::to_string(width) + "x" + std::to_string(height));
+    return ctx;
+}
+
+void RenderTargetPool::destroy(RenderContext* target) {
+    GLState& gl = GLState::getInstance();
+    gl.deleteFramebuffer(target->framebuffer);
+    gl.deleteTexture(target->colorTexture);
+    delete target;
+}
@@ -1,75 +1,221 @@
+#include <algorithm>
 #include <cmath>
-#include <iostream>
+#include <cstddef>
 
 #include "system/Renderer2D.h"
+#include "system/GLState.h"
+#include "system/TextureLoader.h"
+#include "system/PlotBuffer.h"
 #include "system/Logger.h"
+#include "system/ShaderCache.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
-const char* vertexShaderSource = R"(
+static const size_t MAX_BATCH_VERTICES = 65536;
+static const size_t MAX_BATCH_INDICES = MAX_BATCH_VERTICES / 4 * 6;
+static const GLuint PLOT_TEXTURE_UNIT = 3;
+
+const char* batchVertexShaderSource = R"(
 #version 330 core
 layout (location = 0) in vec2 aPos;
-layout (location = 1) in vec4 aColor;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec4 aColor;
 
+out vec2 TexCoord;
 out vec4 ourColor;
-uniform mat4 projection;
+
+layout (std140) uniform Projection {
+    mat4 projection;
+};
 
 void main() {
     gl_Position = projection * vec4(aPos, 0.0, 1.0);
+    TexCoord = aTexCoord;
     ourColor = aColor;
 }
 )";
 
-const char* fragmentShaderSource = R"(
+const char* batchFragmentShaderSource = R"(
 #version 330 core
+in vec2 TexCoord;
 in vec4 ourColor;
 out vec4 FragColor;
 
+uniform sampler2D texture1;
+
 void main() {
-    FragColor = ourColor;
+    FragColor = texture(texture1, TexCoord) * ourColor;
 }
 )";
 
-const char* textureVertexShaderSource = R"(
+const char* instanceVertexShaderSource = R"(
 #version 330 core
-layout (location = 0) in vec2 aPos;
-layout (location = 1) in vec2 aTexCoord;
+layout (location = 0) in vec2 aCorner;
+layout (location = 1) in vec4 aRect;
+layout (location = 2) in vec4 aUV;
+layout (location = 3) in vec4 aColor;
 
 out vec2 TexCoord;
-uniform mat4 projection;
+out vec4 ourColor;
+
+layout (std140) uniform Projection {
+    mat4 projection;
+};
+
+void main() {
+    vec2 pos = aRect.xy + aCorner * aRect.zw;
+    gl_Position = projection * vec4(pos, 0.0, 1.0);
+    TexCoord = mix(aUV.xy, aUV.zw, aCorner);
+    ourColor = aColor;
+}
+)";
+
+const char* shapeVertexShaderSource = R"(
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aLocal;
+layout (location = 2) in vec4 aShape;
+layout (location = 3) in float aSoftness;
+layout (location = 4) in vec4 aColor;
+
+out vec2 Local;
+flat out vec4 Shape;
+flat out float Softness;
+out vec4 ourColor;
+
+layout (std140) uniform Projection {
+    mat4 projection;
+};
 
 void main() {
     gl_Position = projection * vec4(aPos, 0.0, 1.0);
-    TexCoord = aTexCoord;
+    Local = aLocal;
+    Shape = aShape;
+    Softness = aSoftness;
+    ourColor = aColor;
 }
 )";
 
-const char* textureFragmentShaderSource = R"(
+const char* shapeFragmentShaderSource = R"(
 #version 330 core
-in vec2 TexCoord;
+in vec2 Local;
+flat in vec4 Shape;
+flat in float Softness;
+in vec4 ourColor;
 out vec4 FragColor;
 
-uniform sampler2D texture1;
-uniform vec4 tintColor;
+float roundedBox(vec2 p, vec2 halfSize, float radius) {
+    vec2 q = abs(p) - halfSize + radius;
+    return length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+}
 
 void main() {
-    vec4 texColor = texture(texture1, TexCoord);
-    FragColor = texColor * tintColor;
+    float d = roundedBox(Local, Shape.xy, Shape.z);
+    if (Shape.w > 0.0) {
+        d = abs(d + Shape.w * 0.5) - Shape.w * 0.5;
+    }
+
+    float edge = max(Softness, fwidth(d));
+    float coverage = 1.0 - smoothstep(-edge * 0.5, edge * 0.5, d);
+    FragColor = vec4(ourColor.rgb, ourColor.a * coverage);
+}
+)";
+
+// Expands a buffer of data points into a mitered triangle strip, two
+// vertices per point, with a one pixel fringe for antialiasing.
+const char* plotVertexShaderSource = R"(
+#version 330 core
+layout (std140) uniform Projection {
+    mat4 projection;
+};
+
+uniform samplerBuffer Points;
+uniform int Count;
+uniform vec4 DataRange;
+uniform vec4 Area;
+uniform float HalfWidth;
+uniform float MiterLimit;
+
+out float Edge;
+
+vec2 toScreen(int i) {
+    vec2 p = texelFetch(Points, clamp(i, 0, Count - 1)).xy;
+    vec2 t = (p - DataRange.xy) / DataRange.zw;
+    return vec2(Area.x + t.x * Area.z, Area.y + (1.0 - t.y) * Area.w);
+}
+
+vec2 normalOf(vec2 a, vec2 b) {
+    vec2 d = b - a;
+    float len = length(d);
+    return len > 1e-4 ? vec2(-d.y, d.x) / len : vec2(0.0);
+}
+
+void main() {
+    int i = gl_VertexID / 2;
+    float side = (gl_VertexID % 2 == 0) ? -1.0 : 1.0;
+
+    vec2 p = toScreen(i);
+    vec2 n0 = normalOf(toScreen(i - 1), p);
+    vec2 n1 = normalOf(p, toScreen(i + 1));
+    if (dot(n0, n0) == 0.0) n0 = n1;
+    if (dot(n1, n1) == 0.0) n1 = n0;
+
+    // m * 2 / |m|^2 is the miter, 1 / cos(half the turn) long.
+    vec2 m = n0 + n1;
+    float m2 = dot(m, m);
+    vec2 miter;
+    if (m2 * MiterLimit * MiterLimit >= 4.0) {
+        miter = m * (2.0 / m2);
+    } else {
+        miter = m2 > 1e-8 ? normalize(m) * MiterLimit : n1;
+    }
+
+    float extent = HalfWidth + 1.0;
+    Edge = side * extent;
+    gl_Position = projection * vec4(p + miter * side * extent, 0.0, 1.0);
+}
+)";
+
+const char* plotFragmentShaderSource = R"(
+#version 330 core
+in float Edge;
+out vec4 FragColor;
+
+uniform vec4 LineColor;
+uniform float HalfWidth;
+
+void main() {
+    float coverage = clamp(HalfWidth + 0.5 - abs(Edge), 0.0, 1.0);
+    FragColor = vec4(LineColor.rgb, LineColor.a * coverage);
 }
 )";
 
 Renderer2D::Renderer2D() 
-    : shaderProgram_(0), textureShaderProgram_(0), VAO_(0), VBO_(0), EBO_(0),
-      screenWidth_(0), screenHeight_(0), currentColor_(1.0f, 1.0f, 1.0f, 1.0f) {
+    : shaderProgram_(0), instanceShaderProgram_(0), shapeShaderProgram_(0), plotShaderProgram_(0), whiteTexture_(0),
+      VAO_(0), VBO_(0), EBO_(0), shapeVAO_(0), shapeVBO_(0), plotVAO_(0),
+      instanceVAO_(0), instanceQuadVBO_(0), instanceEBO_(0), instanceVBO_(0), instanceCapacity_(0),
+      screenWidth_(0), screenHeight_(0), currentColor_(1.0f, 1.0f, 1.0f, 1.0f),
+      batchMode_(BatchMode::SPRITE), batchTexture_(0), batchDepth_(0) {
 }
 
 Renderer2D::~Renderer2D() {
-    if (VAO_) glDeleteVertexArrays(1, &VAO_);
-    if (VBO_) glDeleteBuffers(1, &VBO_);
-    if (EBO_) glDeleteBuffers(1, &EBO_);
-    if (shaderProgram_) glDeleteProgram(shaderProgram_);
-    if (textureShaderProgram_) glDeleteProgram(textureShaderProgram_);
+    GLState& gl = GLState::getInstance();
+    gl.deleteVertexArray(VAO_);
+    gl.deleteBuffer(VBO_);
+    gl.deleteBuffer(EBO_);
+    gl.deleteVertexArray(shapeVAO_);
+    gl.deleteBuffer(shapeVBO_);
+    gl.deleteVertexArray(plotVAO_);
+    gl.deleteVertexArray(instanceVAO_);
+    gl.deleteBuffer(instanceQuadVBO_);
+    gl.deleteBuffer(instanceEBO_);
+    gl.deleteBuffer(instanceVBO_);
+    gl.deleteTexture(whiteTexture_);
+    gl.deleteProgram(shaderProgram_);
+    gl.deleteProgram(instanceShaderProgram_);
+    gl.deleteProgram(shapeShaderProgram_);
+    gl.deleteProgram(plotShaderProgram_);
 }
 
 bool Renderer2D::initialize(int width, int height) {
@@ -87,7 +233,7 @@ bool Renderer2D::initialize(int width, int height) {
 }
 
 GLuint Renderer2D::loadTexture(const std::string& filepath, bool flipVertically) {
-    stbi_set_flip_vertically_on_load(flipVertically);
+    stbi_set_flip_vertically_on_load_thread(flipVertically);
     
     int width, height, channels;
     unsigned char* data = stbi_load(filepath.c_str(), &width, &height, &channels, 0);
@@ -99,7 +245,7 @@ GLuint Renderer2D::loadTexture(const std::string& filepath, bool flipVertically)
     
     GLuint textureID;
     glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    GLState::getInstance().bindTexture(0, textureID);
     
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -128,7 +274,11 @@ GLuint Renderer2D::loadTexture(const std::string& filepath, bool flipVertically)
 
 void Renderer2D::unloadTexture(GLuint textureID) {
     if (textureID != 0) {
-        glDeleteTextures(1, &textureID);
+        if (textureID == batchTexture_) {
+            flush();
+            batchTexture_ = 0;
+        }
+        GLState::getInstance().deleteTexture(textureID);
     }
 }
 
@@ -136,132 +286,376 @@ void Renderer2D::drawTextureFullscreen(GLuint textureID, const Color& tint) {
     drawTexture(textureID, 0, 0, (float)screenWidth_, (float)screenHeight_, tint);
 }
 
-bool Renderer2D::compileShaders() {
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vertexShader);
-    
-    GLint success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
-        std::cerr << "Vertex Shader Compilation Failed:\n" << infoLog << std::endl;
-        return false;
+void Renderer2D::drawTextureFullscreen(const AsyncTexture& texture, const Color& tint) {
+    drawTexture(texture, 0, 0, (float)screenWidth_, (float)screenHeight_, tint);
+}
+
+static GLuint buildProgram(const std::string& name, const char* vertexSource, const char* fragmentSource) {
+    GLuint program = ShaderCache::getInstance().buildProgram(name, vertexSource, fragmentSource);
+    if (!program) {
+        return 0;
     }
     
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fragmentShader);
+    GLState& gl = GLState::getInstance();
+    gl.attachProjectionBlock(program);
+    gl.useProgram(program);
+    glUniform1i(gl.getUniformLocation(program, "texture1"), 0);
     
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
-        std::cerr << "Fragment Shader Compilation Failed:\n" << infoLog << std::endl;
+    return program;
+}
+
+bool Renderer2D::compileShaders() {
+    shaderProgram_ = buildProgram("Sprite batch", batchVertexShaderSource, batchFragmentShaderSource);
+    if (!shaderProgram_) {
         return false;
     }
     
-    shaderProgram_ = glCreateProgram();
-    glAttachShader(shaderProgram_, vertexShader);
-    glAttachShader(shaderProgram_, fragmentShader);
-    glLinkProgram(shaderProgram_);
-    
-    glGetProgramiv(shaderProgram_, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram_, 512, nullptr, infoLog);
-        std::cerr << "Shader Program Linking Failed:\n" << infoLog << std::endl;
+    instanceShaderProgram_ = buildProgram("Sprite instance", instanceVertexShaderSource, batchFragmentShaderSource);
+    if (!instanceShaderProgram_) {
         return false;
     }
     
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-    
-    GLuint texVertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(texVertexShader, 1, &textureVertexShaderSource, nullptr);
-    glCompileShader(texVertexShader);
-    
-    GLuint texFragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(texFragmentShader, 1, &textureFragmentShaderSource, nullptr);
-    glCompileShader(texFragmentShader);
-    
-    textureShaderProgram_ = glCreateProgram();
-    glAttachShader(textureShaderProgram_, texVertexShader);
-    glAttachShader(textureShaderProgram_, texFragmentShader);
-    glLinkProgram(textureShaderProgram_);
+    shapeShaderProgram_ = buildProgram("Shape", shapeVertexShaderSource, shapeFragmentShaderSource);
+    if (!shapeShaderProgram_) {
+        return false;
+    }
     
-    glDeleteShader(texVertexShader);
-    glDeleteShader(texFragmentShader);
+    plotShaderProgram_ = buildProgram("Plot", plotVertexShaderSource, plotFragmentShaderSource);
+    if (!plotShaderProgram_) {
+        return false;
+    }
+    glUniform1i(GLState::getInstance().getUniformLocation(plotShaderProgram_, "Points"), PLOT_TEXTURE_UNIT);
     
     return true;
 }
 
 void Renderer2D::setupBuffers() {
+    GLState& gl = GLState::getInstance();
+    
     glGenVertexArrays(1, &VAO_);
     glGenBuffers(1, &VBO_);
     glGenBuffers(1, &EBO_);
     
-    glBindVertexArray(VAO_);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO_);
+    gl.bindVertexArray(VAO_);
+    gl.bindBuffer(GL_ARRAY_BUFFER, VBO_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(BatchVertex) * MAX_BATCH_VERTICES, nullptr, GL_STREAM_DRAW);
     
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 1000, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * MAX_BATCH_INDICES, nullptr, GL_STREAM_DRAW);
     
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(BatchVertex), (void*)offsetof(BatchVertex, x));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(BatchVertex), (void*)offsetof(BatchVertex, u));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(BatchVertex), (void*)offsetof(BatchVertex, r));
+    
+    gl.bindVertexArray(0);
+    
+    // Shapes share the index buffer (and index list) with the sprite batch;
+    // only one of the two is ever pending at a time.
+    glGenVertexArrays(1, &shapeVAO_);
+    glGenBuffers(1, &shapeVBO_);
+    
+    gl.bindVertexArray(shapeVAO_);
+    gl.bindBuffer(GL_ARRAY_BUFFER, shapeVBO_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(ShapeVertex) * MAX_BATCH_VERTICES, nullptr, GL_STREAM_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * 1000, nullptr, GL_DYNAMIC_DRAW);
     
-    glBindVertexArray(0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(ShapeVertex), (void*)offsetof(ShapeVertex, x));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ShapeVertex), (void*)offsetof(ShapeVertex, localX));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ShapeVertex), (void*)offsetof(ShapeVertex, halfWidth));
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(ShapeVertex), (void*)offsetof(ShapeVertex, softness));
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(ShapeVertex), (void*)offsetof(ShapeVertex, r));
+    
+    gl.bindVertexArray(0);
+    
+    // Plot vertices are generated from gl_VertexID; core profile still
+    // wants a VAO bound.
+    glGenVertexArrays(1, &plotVAO_);
+    
+    unsigned char whitePixel[4] = { 255, 255, 255, 255 };
+    glGenTextures(1, &whiteTexture_);
+    gl.bindTexture(0, whiteTexture_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, whitePixel);
+    
+    // Unit quad shared by every instance; the per-instance rect places it.
+    float corners[] = {
+        0.0f, 0.0f,
+        1.0f, 0.0f,
+        1.0f, 1.0f,
+        0.0f, 1.0f
+    };
+    unsigned int quadIndices[] = { 0, 1, 2, 2, 3, 0 };
+    
+    glGenVertexArrays(1, &instanceVAO_);
+    glGenBuffers(1, &instanceQuadVBO_);
+    glGenBuffers(1, &instanceEBO_);
+    glGenBuffers(1, &instanceVBO_);
+    
+    gl.bindVertexArray(instanceVAO_);
+    gl.bindBuffer(GL_ARRAY_BUFFER, instanceQuadVBO_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, instanceEBO_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quadIndices), quadIndices, GL_STATIC_DRAW);
+    
+    instanceCapacity_ = 1024;
+    gl.bindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(SpriteInstance) * instanceCapacity_, nullptr, GL_STREAM_DRAW);
+    
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, x));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, u0));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, r));
+    glVertexAttribDivisor(3, 1);
+    
+    gl.bindVertexArray(0);
+    
+    batchVertices_.reserve(MAX_BATCH_VERTICES);
+    shapeVertices_.reserve(MAX_BATCH_VERTICES);
+    batchIndices_.reserve(MAX_BATCH_INDICES);
 }
 
 void Renderer2D::setViewport(int width, int height) {
+    flush();
+    
     screenWidth_ = width;
     screenHeight_ = height;
     
     projection_ = glm::ortho(0.0f, (float)width, (float)height, 0.0f, -1.0f, 1.0f);
+    GLState::getInstance().setProjection(projection_);
     
     glViewport(0, 0, width, height);
 }
 
 void Renderer2D::clear(const Color& color) {
+    flush();
+    
     glClearColor(color.r, color.g, color.b, color.a);
     glClear(GL_COLOR_BUFFER_BIT);
 }
 
-void Renderer2D::drawRect(float x, float y, float width, float height, const Color& color) {
-    float vertices[] = {
-        x, y,            color.r, color.g, color.b, color.a,
-        x + width, y,    color.r, color.g, color.b, color.a,
-        x + width, y + height, color.r, color.g, color.b, color.a,
-        x, y + height,   color.r, color.g, color.b, color.a
-    };
+void Renderer2D::beginBatch() {
+    batchDepth_++;
+}
+
+void Renderer2D::endBatch() {
+    if (batchDepth_ > 0) {
+        batchDepth_--;
+    }
     
-    unsigned int indices[] = {
-        0, 1, 2,
-        2, 3, 0
-    };
+    if (batchDepth_ == 0) {
+        flush();
+    }
+}
+
+void Renderer2D::flush() {
+    if (batchIndices_.empty()) {
+        batchVertices_.clear();
+        shapeVertices_.clear();
+        return;
+    }
     
-    glUseProgram(shaderProgram_);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram_, "projection"), 1, GL_FALSE, &projection_[0][0]);
+    GLState& gl = GLState::getInstance();
+    gl.setProjection(projection_);
+    
+    // Orphan the previous storage so the driver never stalls on a buffer the
+    // GPU is still reading from.
+    size_t vertexCount;
+    if (batchMode_ == BatchMode::SHAPE) {
+        gl.useProgram(shapeShaderProgram_);
+        gl.bindVertexArray(shapeVAO_);
+        gl.bindBuffer(GL_ARRAY_BUFFER, shapeVBO_);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(ShapeVertex) * MAX_BATCH_VERTICES, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, shapeVertices_.size() * sizeof(ShapeVertex), shapeVertices_.data());
+        vertexCount = shapeVertices_.size();
+    } else {
+        gl.useProgram(shaderProgram_);
+        gl.bindTexture(0, batchTexture_ ? batchTexture_ : whiteTexture_);
+        gl.bindVertexArray(VAO_);
+        gl.bindBuffer(GL_ARRAY_BUFFER, VBO_);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(BatchVertex) * MAX_BATCH_VERTICES, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, batchVertices_.size() * sizeof(BatchVertex), batchVertices_.data());
+        vertexCount = batchVertices_.size();
+    }
     
-    glBindVertexArray(VAO_);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO_);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * MAX_BATCH_INDICES, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, batchIndices_.size() * sizeof(unsigned int), batchIndices_.data());
     
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(indices), indices);
+    glDrawElements(GL_TRIANGLES, (GLsizei)batchIndices_.size(), GL_UNSIGNED_INT, 0);
     
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(2 * sizeof(float)));
+    frameStats_.drawCalls++;
+    frameStats_.vertices += (int)vertexCount;
     
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    batchVertices_.clear();
+    shapeVertices_.clear();
+    batchIndices_.clear();
+}
+
+void Renderer2D::resetFrameStats() {
+    lastFrameStats_ = frameStats_;
+    frameStats_ = RenderStats();
+}
+
+void Renderer2D::setBatchMode(BatchMode mode) {
+    if (mode != batchMode_) {
+        flush();
+        batchMode_ = mode;
+    }
+}
+
+void Renderer2D::setBatchTexture(GLuint textureID) {
+    setBatchMode(BatchMode::SPRITE);
+    
+    if (textureID == whiteTexture_) {
+        textureID = 0;
+    }
+    
+    if (textureID != batchTexture_) {
+        flush();
+        batchTexture_ = textureID;
+    }
+}
+
+void Renderer2D::reserveBatch(size_t vertexCount, size_t indexCount) {
+    size_t pending = batchMode_ == BatchMode::SHAPE ? shapeVertices_.size() : batchVertices_.size();
+    if (pending + vertexCount > MAX_BATCH_VERTICES ||
+        batchIndices_.size() + indexCount > MAX_BATCH_INDICES) {
+        flush();
+    }
+}
+
+void Renderer2D::pushQuad(const BatchVertex& v0, const BatchVertex& v1, const BatchVertex& v2, const BatchVertex& v3) {
+    reserveBatch(4, 6);
+    
+    unsigned int base = (unsigned int)batchVertices_.size();
+    batchVertices_.push_back(v0);
+    batchVertices_.push_back(v1);
+    batchVertices_.push_back(v2);
+    batchVertices_.push_back(v3);
+    
+    batchIndices_.push_back(base + 0);
+    batchIndices_.push_back(base + 1);
+    batchIndices_.push_back(base + 2);
+    batchIndices_.push_back(base + 2);
+    batchIndices_.push_back(base + 3);
+    batchIndices_.push_back(base + 0);
+}
+
+void Renderer2D::pushShape(float cx, float cy, float halfWidth, float halfHeight, float radius, float stroke,
+                           float softness, const Color& color) {
+    setBatchMode(BatchMode::SHAPE);
+    reserveBatch(4, 6);
+    
+    radius = std::min(std::max(radius, 0.0f), std::min(halfWidth, halfHeight));
+    
+    // Grow the quad past the shape so the antialiased (or blurred) edge is
+    // not clipped.
+    float pad = softness + 1.0f;
+    float ex = halfWidth + pad;
+    float ey = halfHeight + pad;
+    
+    unsigned int base = (unsigned int)shapeVertices_.size();
+    shapeVertices_.push_back({ cx - ex, cy - ey, -ex, -ey, halfWidth, halfHeight, radius, stroke, softness,
+                               color.r, color.g, color.b, color.a });
+    shapeVertices_.push_back({ cx + ex, cy - ey,  ex, -ey, halfWidth, halfHeight, radius, stroke, softness,
+                               color.r, color.g, color.b, color.a });
+    shapeVertices_.push_back({ cx + ex, cy + ey,  ex,  ey, halfWidth, halfHeight, radius, stroke, softness,
+                               color.r, color.g, color.b, color.a });
+    shapeVertices_.push_back({ cx - ex, cy + ey, -ex,  ey, halfWidth, halfHeight, radius, stroke, softness,
+                               color.r, color.g, color.b, color.a });
+    
+    batchIndices_.push_back(base + 0);
+    batchIndices_.push_back(base + 1);
+    batchIndices_.push_back(base + 2);
+    batchIndices_.push_back(base + 2);
+    batchIndices_.push_back(base + 3);
+    batchIndices_.push_back(base + 0);
+    
+    flushIfImmediate();
+}
+
+size_t Renderer2D::allocateQuads(GLuint textureID, size_t count, BatchVertex*& vertices) {
+    vertices = nullptr;
+    if (count == 0) return 0;
+    
+    setBatchTexture(textureID);
+    if (batchVertices_.size() + 4 > MAX_BATCH_VERTICES) {
+        flush();
+    }
+    
+    size_t room = (MAX_BATCH_VERTICES - batchVertices_.size()) / 4;
+    count = std::min(count, room);
+    
+    unsigned int base = (unsigned int)batchVertices_.size();
+    batchVertices_.resize(batchVertices_.size() + count * 4);
+    
+    size_t firstIndex = batchIndices_.size();
+    batchIndices_.resize(firstIndex + count * 6);
+    unsigned int* indices = batchIndices_.data() + firstIndex;
+    
+    for (size_t i = 0; i < count; ++i) {
+        unsigned int quad = base + (unsigned int)(i * 4);
+        indices[0] = quad + 0;
+        indices[1] = quad + 1;
+        indices[2] = quad + 2;
+        indices[3] = quad + 2;
+        indices[4] = quad + 3;
+        indices[5] = quad + 0;
+        indices += 6;
+    }
+    
+    vertices = batchVertices_.data() + base;
+    return count;
+}
+
+void Renderer2D::flushIfImmediate() {
+    if (batchDepth_ == 0) {
+        flush();
+    }
+}
+
+void Renderer2D::drawRect(float x, float y, float width, float height, const Color& color) {
+    setBatchTexture(0);
+    pushQuad(
+        { x, y,                  0.0f, 0.0f, color.r, color.g, color.b, color.a },
+        { x + width, y,          1.0f, 0.0f, color.r, color.g, color.b, color.a },
+        { x + width, y + height, 1.0f, 1.0f, color.r, color.g, color.b, color.a },
+        { x, y + height,         0.0f, 1.0f, color.r, color.g, color.b, color.a }
+    );
+    flushIfImmediate();
 }
 
 void Renderer2D::drawRectOutline(float x, float y, float width, float height, float thickness, const Color& color) {
-    drawRect(x, y, width, thickness, color);
-    drawRect(x, y + height - thickness, width, thickness, color);
-    drawRect(x, y, thickness, height, color);
-    drawRect(x + width - thickness, y, thickness, height, color);
+    drawRoundedRectOutline(x, y, width, height, 0.0f, thickness, color);
+}
+
+void Renderer2D::drawRoundedRect(float x, float y, float width, float height, float radius, const Color& color) {
+    pushShape(x + width * 0.5f, y + height * 0.5f, width * 0.5f, height * 0.5f, radius, 0.0f, 0.0f, color);
+}
+
+void Renderer2D::drawRoundedRectOutline(float x, float y, float width, float height, float radius, float thickness,
+                                        const Color& color) {
+    if (thickness <= 0.0f) return;
+    pushShape(x + width * 0.5f, y + height * 0.5f, width * 0.5f, height * 0.5f, radius, thickness, 0.0f, color);
+}
+
+void Renderer2D::drawShadow(float x, float y, float width, float height, float radius, float blur, const Color& color) {
+    pushShape(x + width * 0.5f, y + height * 0.5f, width * 0.5f, height * 0.5f, radius, 0.0f, std::max(blur, 0.0f), color);
 }
 
 void Renderer2D::drawLine(float x1, float y1, float x2, float y2, float thickness, const Color& color) {
@@ -276,119 +670,285 @@ void Renderer2D::drawLine(float x1, float y1, float x2, float y2, float thicknes
     
     float halfThickness = thickness * 0.5f;
     
-    float vertices[] = {
-        x1 + nx * halfThickness, y1 + ny * halfThickness, color.r, color.g, color.b, color.a,
-        x2 + nx * halfThickness, y2 + ny * halfThickness, color.r, color.g, color.b, color.a,
-        x2 - nx * halfThickness, y2 - ny * halfThickness, color.r, color.g, color.b, color.a,
-        x1 - nx * halfThickness, y1 - ny * halfThickness, color.r, color.g, color.b, color.a
-    };
+    setBatchTexture(0);
+    pushQuad(
+        { x1 + nx * halfThickness, y1 + ny * halfThickness, 0.0f, 0.0f, color.r, color.g, color.b, color.a },
+        { x2 + nx * halfThickness, y2 + ny * halfThickness, 1.0f, 0.0f, color.r, color.g, color.b, color.a },
+        { x2 - nx * halfThickness, y2 - ny * halfThickness, 1.0f, 1.0f, color.r, color.g, color.b, color.a },
+        { x1 - nx * halfThickness, y1 - ny * halfThickness, 0.0f, 1.0f, color.r, color.g, color.b, color.a }
+    );
+    flushIfImmediate();
+}
+
+void Renderer2D::drawPolyline(const glm::vec2* points, size_t count, float thickness, const Color& color,
+                              LineJoin join, bool closed) {
+    if (!points || count < 2 || thickness <= 0.0f) return;
     
-    unsigned int indices[] = {
-        0, 1, 2,
-        2, 3, 0
-    };
+    setBatchTexture(0);
+    
+    float halfThickness = thickness * 0.5f;
+    size_t segments = closed ? count : count - 1;
     
-    glUseProgram(shaderProgram_);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram_, "projection"), 1, GL_FALSE, &projection_[0][0]);
+    auto normalOf = [points, count](size_t segment) {
+        glm::vec2 d = points[(segment + 1) % count] - points[segment];
+        float length = glm::length(d);
+        return length > 0.0001f ? glm::vec2(-d.y, d.x) / length : glm::vec2(0.0f);
+    };
     
-    glBindVertexArray(VAO_);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO_);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+    // Offset of the miter corner both segments meet at, or false if the
+    // joint is too sharp.
+    // n0 + n1 scaled by 2 / |n0 + n1|^2 is 1 / cos(half the turn) long.
+    auto miterOffset = [halfThickness](const glm::vec2& n0, const glm::vec2& n1, glm::vec2& offset) {
+        glm::vec2 m = n0 + n1;
+        float m2 = glm::dot(m, m);
+        if (m2 * RENDERER_MITER_LIMIT * RENDERER_MITER_LIMIT < 4.0f) return false;
+        
+        offset = m * (2.0f * halfThickness / m2);
+        return true;
+    };
     
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(indices), indices);
+    // Repeated points make zero-length segments without a normal. They are
+    // skipped, and the segments on either side join as if they touched.
+    const glm::vec2 zero(0.0f);
+    size_t first = 0;
+    while (first < segments && normalOf(first) == zero) {
+        ++first;
+    }
+    if (first == segments) return;
+    
+    size_t end = closed ? first + segments : segments;
+    glm::vec2 normal = normalOf(first);
+    glm::vec2 previous = zero;
+    if (closed) {
+        for (size_t i = 1; i < segments && previous == zero; ++i) {
+            previous = normalOf((first + segments - i) % segments);
+        }
+    }
     
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(2 * sizeof(float)));
+    size_t s = first;
+    while (s < end) {
+        size_t t = s + 1;
+        glm::vec2 next = zero;
+        while (t < end && next == zero) {
+            next = normalOf(t % segments);
+            if (next == zero) ++t;
+        }
+        if (next == zero && closed) {
+            next = normalOf(first);
+        }
+        
+        // A zero previous or next normal means an open end; ends are straight.
+        glm::vec2 startOffset = normal * halfThickness;
+        glm::vec2 endOffset = normal * halfThickness;
+        bool endMitered = false;
+        
+        if (join == LineJoin::MITER) {
+            if (previous != zero) {
+                miterOffset(previous, normal, startOffset);
+            }
+            endMitered = next == zero || miterOffset(normal, next, endOffset);
+        }
+        
+        size_t segment = s % segments;
+        const glm::vec2& a = points[segment];
+        const glm::vec2& b = points[(segment + 1) % count];
+        
+        pushQuad(
+            { a.x + startOffset.x, a.y + startOffset.y, 0.0f, 0.0f, color.r, color.g, color.b, color.a },
+            { b.x + endOffset.x,   b.y + endOffset.y,   1.0f, 0.0f, color.r, color.g, color.b, color.a },
+            { b.x - endOffset.x,   b.y - endOffset.y,   1.0f, 1.0f, color.r, color.g, color.b, color.a },
+            { a.x - startOffset.x, a.y - startOffset.y, 0.0f, 1.0f, color.r, color.g, color.b, color.a }
+        );
+        
+        if (!endMitered && next != zero) {
+            pushJoin(b, normal, next, halfThickness, join, color);
+        }
+        
+        previous = normal;
+        normal = next;
+        s = t;
+    }
     
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    flushIfImmediate();
 }
 
-void Renderer2D::drawCircle(float x, float y, float radius, const Color& color, int segments) {
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
-    
-    vertices.push_back(x);
-    vertices.push_back(y);
-    vertices.push_back(color.r);
-    vertices.push_back(color.g);
-    vertices.push_back(color.b);
-    vertices.push_back(color.a);
-    
-    for (int i = 0; i <= segments; i++) {
-        float angle = 2.0f * M_PI * i / segments;
-        float px = x + radius * std::cos(angle);
-        float py = y + radius * std::sin(angle);
-        
-        vertices.push_back(px);
-        vertices.push_back(py);
-        vertices.push_back(color.r);
-        vertices.push_back(color.g);
-        vertices.push_back(color.b);
-        vertices.push_back(color.a);
+void Renderer2D::drawPolyline(const std::vector<glm::vec2>& points, float thickness, const Color& color,
+                              LineJoin join, bool closed) {
+    drawPolyline(points.data(), points.size(), thickness, color, join, closed);
+}
+
+void Renderer2D::pushJoin(const glm::vec2& point, const glm::vec2& normalIn, const glm::vec2& normalOut,
+                          float halfThickness, LineJoin join, const Color& color) {
+    // Only the outer side of the turn has a gap; the inner side overlaps.
+    // Turning towards +normalIn puts the outer side at -normalIn.
+    glm::vec2 directionOut(normalOut.y, -normalOut.x);
+    float side = glm::dot(directionOut, normalIn) > 0.0f ? -1.0f : 1.0f;
+    
+    glm::vec2 from = normalIn * (side * halfThickness);
+    glm::vec2 to = normalOut * (side * halfThickness);
+    
+    BatchVertex center = { point.x, point.y, 0.5f, 0.5f, color.r, color.g, color.b, color.a };
+    auto rim = [&point, &color](const glm::vec2& offset) {
+        return BatchVertex{ point.x + offset.x, point.y + offset.y, 0.5f, 0.5f, color.r, color.g, color.b, color.a };
+    };
+    
+    if (join != LineJoin::ROUND) {
+        pushQuad(center, rim(from), rim(to), rim(to));
+        return;
     }
     
-    for (int i = 1; i <= segments; i++) {
-        indices.push_back(0);
-        indices.push_back(i);
-        indices.push_back(i + 1);
+    // Enough fan steps to keep the chord within a quarter pixel of the arc.
+    float angle = std::acos(std::clamp(glm::dot(normalIn, normalOut), -1.0f, 1.0f));
+    float maxStep = 2.0f * std::acos(std::max(1.0f - 0.25f / std::max(halfThickness, 0.25f), -1.0f));
+    int steps = std::clamp((int)std::ceil(angle / std::max(maxStep, 0.01f)), 1, 32);
+    
+    float step = (from.x * to.y - from.y * to.x >= 0.0f ? angle : -angle) / steps;
+    auto arc = [&from, &to, step, steps](int k) {
+        if (k >= steps) return to;
+        float c = std::cos(step * k);
+        float s = std::sin(step * k);
+        return glm::vec2(from.x * c - from.y * s, from.x * s + from.y * c);
+    };
+    
+    // Two fan triangles per quad: (center, k, k+1) and (k+1, k+2, center).
+    for (int k = 0; k < steps; k += 2) {
+        pushQuad(center, rim(arc(k)), rim(arc(k + 1)), rim(arc(std::min(k + 2, steps))));
     }
+}
+
+void Renderer2D::drawPlot(const PlotBuffer& plot, const Rect& dataRange, const Rect& area, float thickness,
+                          const Color& color) {
+    if (plot.size() < 2 || thickness <= 0.0f) return;
     
-    glUseProgram(shaderProgram_);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram_, "projection"), 1, GL_FALSE, &projection_[0][0]);
+    // Anything already batched has to land underneath the plot.
+    flush();
     
-    glBindVertexArray(VAO_);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO_);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
+    Rect range = dataRange;
+    if (range.width == 0.0f) range.width = 1.0f;
+    if (range.height == 0.0f) range.height = 1.0f;
     
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(unsigned int), indices.data());
+    GLState& gl = GLState::getInstance();
+    gl.setProjection(projection_);
+    gl.useProgram(plotShaderProgram_);
+    gl.bindVertexArray(plotVAO_);
     
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(2 * sizeof(float)));
+    gl.setActiveUnit(PLOT_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, plot.getTexture());
+    
+    glUniform1i(gl.getUniformLocation(plotShaderProgram_, "Count"), (GLint)plot.size());
+    glUniform4f(gl.getUniformLocation(plotShaderProgram_, "DataRange"), range.x, range.y, range.width, range.height);
+    glUniform4f(gl.getUniformLocation(plotShaderProgram_, "Area"), area.x, area.y, area.width, area.height);
+    glUniform1f(gl.getUniformLocation(plotShaderProgram_, "HalfWidth"), thickness * 0.5f);
+    glUniform1f(gl.getUniformLocation(plotShaderProgram_, "MiterLimit"), RENDERER_MITER_LIMIT);
+    glUniform4f(gl.getUniformLocation(plotShaderProgram_, "LineColor"), color.r, color.g, color.b, color.a);
+    
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, (GLsizei)(plot.size() * 2));
+    
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
     
-    glDrawElements(GL_TRIANGLES, (GLsizei)indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    frameStats_.drawCalls++;
+    frameStats_.vertices += (int)(plot.size() * 2);
 }
 
-void Renderer2D::drawTexture(GLuint textureID, float x, float y, float width, float height, const Color& tint) {
-    float vertices[] = {
-        x, y,               0.0f, 0.0f,
-        x + width, y,       1.0f, 0.0f,
-        x + width, y + height, 1.0f, 1.0f,
-        x, y + height,      0.0f, 1.0f
-    };
+void Renderer2D::drawPlot(const PlotBuffer& plot, const Rect& area, float thickness, const Color& color) {
+    drawPlot(plot, plot.getBounds(), area, thickness, color);
+}
+
+void Renderer2D::drawCircle(float x, float y, float radius, const Color& color, int segments) {
+    if (segments == 0) {
+        pushShape(x, y, radius, radius, radius, 0.0f, 0.0f, color);
+        return;
+    }
+    if (segments < 3) return;
     
-    unsigned int indices[] = {
-        0, 1, 2,
-        2, 3, 0
+    setBatchTexture(0);
+    
+    BatchVertex center = { x, y, 0.5f, 0.5f, color.r, color.g, color.b, color.a };
+    auto corner = [&](int i) {
+        float angle = 2.0f * (float)M_PI * (i % segments) / segments;
+        return BatchVertex{ x + radius * std::cos(angle), y + radius * std::sin(angle), 0.5f, 0.5f,
+                            color.r, color.g, color.b, color.a };
     };
     
-    glUseProgram(textureShaderProgram_);
-    glUniformMatrix4fv(glGetUniformLocation(textureShaderProgram_, "projection"), 1, GL_FALSE, &projection_[0][0]);
-    glUniform4f(glGetUniformLocation(textureShaderProgram_, "tintColor"), tint.r, tint.g, tint.b, tint.a);
+    // Two fan triangles per quad, as in pushJoin().
+    for (int i = 0; i < segments; i += 2) {
+        pushQuad(center, corner(i), corner(i + 1), corner(std::min(i + 2, segments)));
+    }
     
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glUniform1i(glGetUniformLocation(textureShaderProgram_, "texture1"), 0);
+    flushIfImmediate();
+}
+
+void Renderer2D::drawRing(float x, float y, float radius, float thickness, const Color& color) {
+    if (thickness <= 0.0f) return;
+    pushShape(x, y, radius, radius, radius, thickness, 0.0f, color);
+}
+
+void Renderer2D::drawTexture(GLuint textureID, float x, float y, float width, float height, const Color& tint) {
+    drawTexture(textureID, Rect{ 0.0f, 0.0f, 1.0f, 1.0f }, x, y, width, height, tint);
+}
+
+void Renderer2D::drawTexture(GLuint textureID, const Rect& uv, float x, float y, float width, float height, const Color& tint) {
+    float u0 = uv.x;
+    float v0 = uv.y;
+    float u1 = uv.x + uv.width;
+    float v1 = uv.y + uv.height;
+    
+    setBatchTexture(textureID);
+    pushQuad(
+        { x, y,                  u0, v0, tint.r, tint.g, tint.b, tint.a },
+        { x + width, y,          u1, v0, tint.r, tint.g, tint.b, tint.a },
+        { x + width, y + height, u1, v1, tint.r, tint.g, tint.b, tint.a },
+        { x, y + height,         u0, v1, tint.r, tint.g, tint.b, tint.a }
+    );
+    flushIfImmediate();
+}
+
+void Renderer2D::drawTexture(const TextureRegion& region, float x, float y, float width, float height, const Color& tint) {
+    if (!region.isValid()) return;
     
-    glBindVertexArray(VAO_);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO_);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+    Rect uv = { region.u0, region.v0, region.u1 - region.u0, region.v1 - region.v0 };
+    drawTexture(region.textureID, uv, x, y, width, height, tint);
+}
+
+void Renderer2D::drawTextureInstanced(GLuint textureID, const SpriteInstance* instances, size_t count) {
+    if (!instances || count == 0) return;
     
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(indices), indices);
+    // Anything already batched has to land underneath the instances.
+    flush();
     
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    GLState& gl = GLState::getInstance();
+    gl.setProjection(projection_);
+    gl.useProgram(instanceShaderProgram_);
+    gl.bindTexture(0, textureID ? textureID : whiteTexture_);
+    gl.bindVertexArray(instanceVAO_);
+    gl.bindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
     
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-}
\ No newline at end of file
+    while (instanceCapacity_ < count) {
+        instanceCapacity_ *= 2;
+    }
+    
+    glBufferData(GL_ARRAY_BUFFER, sizeof(SpriteInstance) * instanceCapacity_, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(SpriteInstance) * count, instances);
+    
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, (GLsizei)count);
+    
+    frameStats_.drawCalls++;
+    frameStats_.vertices += (int)(count * 4);
+}
+
+void Renderer2D::drawTextureInstanced(GLuint textureID, const std::vector<SpriteInstance>& instances) {
+    drawTextureInstanced(textureID, instances.data(), instances.size());
+}
+
+void Renderer2D::drawTexture(const AsyncTexture& texture, float x, float y, float width, float height, const Color& tint) {
+    float progress = texture.getFadeProgress();
+    
+    if (progress < 1.0f && texture.placeholder.a > 0.0f) {
+        const Color& p = texture.placeholder;
+        drawRect(x, y, width, height, Color(p.r * tint.r, p.g * tint.g, p.b * tint.b, p.a * tint.a));
+    }
+    
+    if (progress > 0.0f) {
+        drawTexture(texture.textureID, x, y, width, height, Color(tint.r, tint.g, tint.b, tint.a * progress));
+    }
+}
@@ -0,0 +1,202 @@
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+#include "system/ScreenshotService.h"
+#include "system/FrameCapture.h"
+#include "system/GLState.h"
+#include "system/Logger.h"
+
+ScreenshotService::ScreenshotService(const std::string& directory, ScreenshotFormat format)
+    : directory_(directory), format_(format) {
+    worker_ = std::thread(&ScreenshotService::workerLoop, this);
+}
+
+ScreenshotService::~ScreenshotService() {
+    shutdown();
+}
+
+void ScreenshotService::capture(const RenderContext* target) {
+    if (!target || !requested_.load(std::memory_order_relaxed)) return;
+
+    Slot* slot = nullptr;
+    for (Slot& candidate : slots_) {
+        if (candidate.state.load() == SlotState::FREE) {
+            slot = &candidate;
+            break;
+        }
+    }
+
+    // Every buffer is still in flight; keep the request for a later frame.
+    if (!slot) return;
+
+    requested_ = false;
+
+    size_t size = (size_t)target->width * target->height * 4;
+    if (slot->buffer == 0) {
+        glGenBuffers(1, &slot->buffer);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->buffer);
+    if (slot->capacity != size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        slot->capacity = size;
+    }
+
+    GLState& gl = GLState::getInstance();
+    GLuint previous = gl.getBoundFramebuffer();
+    gl.bindFramebuffer(target->framebuffer);
+
+    // With a pack buffer bound this only queues the copy; the data pointer
+    // is an offset into the buffer.
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, target->width, target->height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    gl.bindFramebuffer(previous);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot->width = target->width;
+    slot->height = target->height;
+    slot->path = makePath();
+    slot->state = SlotState::READING;
+}
+
+void ScreenshotService::update() {
+    for (Slot& slot : slots_) {
+        SlotState state = slot.state.load();
+
+        if (state == SlotState::READING) {
+            GLenum result = glClientWaitSync(slot.fence, 0, 0);
+            if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) continue;
+
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+            slot.mapped = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.capacity, GL_MAP_READ_BIT);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            if (!slot.mapped) {
+                GAME_LOG_ERROR("Failed to map screenshot buffer");
+                slot.state = SlotState::FREE;
+                continue;
+            }
+
+            slot.state = SlotState::MAPPED;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                jobs_.push_back(&slot);
+            }
+            condition_.notify_one();
+        } else if (state == SlotState::COPIED) {
+            // The worker has its own copy; the buffer can go back to GL.
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            slot.mapped = nullptr;
+            slot.state = SlotState::FREE;
+        }
+    }
+}
+
+void ScreenshotService::shutdown() {
+    // Flush whatever is still on the GPU so no requested screenshot is lost.
+    for (Slot& slot : slots_) {
+        if (slot.state.load() == SlotState::READING) {
+            glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        }
+    }
+
+    while (getPendingCount() > 0) {
+        update();
+        std::this_thread::yield();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    condition_.notify_one();
+
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+
+    for (Slot& slot : slots_) {
+        if (slot.buffer != 0) {
+            glDeleteBuffers(1, &slot.buffer);
+            slot.buffer = 0;
+            slot.capacity = 0;
+        }
+    }
+}
+
+int ScreenshotService::getPendingCount() const {
+    int count = 0;
+    for (const Slot& slot : slots_) {
+        if (slot.state.load() != SlotState::FREE) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void ScreenshotService::workerLoop() {
+    while (true) {
+        Slot* slot = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this] { return !running_ || !jobs_.empty(); });
+
+            if (jobs_.empty()) return;
+
+            slot = jobs_.front();
+            jobs_.pop_front();
+        }
+
+        encode(*slot);
+    }
+}
+
+void ScreenshotService::encode(Slot& slot) {
+    int width = slot.width;
+    int height = slot.height;
+    std::string path = slot.path;
+
+    // Copy out flipped to top-down, then release the mapping before the slow
+    // part so the buffer can be reused.
+    size_t rowSize = (size_t)width * 4;
+    std::vector<unsigned char> pixels(rowSize * height);
+    for (int y = 0; y < height; ++y) {
+        std::memcpy(pixels.data() + rowSize * y, slot.mapped + rowSize * (height - 1 - y), rowSize);
+    }
+    slot.state = SlotState::COPIED;
+
+    bool written = format_ == ScreenshotFormat::QOI
+        ? FrameCapture::writeQOI(path, pixels.data(), width, height)
+        : FrameCapture::writePNG(path, pixels.data(), width, height);
+
+    if (written) {
+        GAME_LOG_INFO("Saved screenshot " + path);
+    }
+}
+
+std::string ScreenshotService::makePath() {
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &local);
+
+    char name[64];
+    snprintf(name, sizeof(name), "screenshot_%s_%03d.%s", stamp, sequence_++ % 1000,
+             format_ == ScreenshotFormat::QOI ? "qoi" : "png");
+
+    return directory_ + "/" + name;
+}
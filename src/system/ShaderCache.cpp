@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "system/ShaderCache.h"
+#include "system/Logger.h"
+#include "utils/MappedFile.h"
+#include "utils/Utils.h"
+
+static std::string getGLString(GLenum name) {
+    const GLubyte* value = glGetString(name);
+    return value ? std::string((const char*)value) : std::string();
+}
+
+void ShaderCache::initialize(const std::string& directory) {
+    directory_ = directory;
+    available_ = false;
+
+    GLint formatCount = 0;
+    if (GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_get_program_binary) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    }
+
+    if (formatCount <= 0) {
+        GAME_LOG_INFO("Program binaries not supported, shaders are compiled at every start");
+        return;
+    }
+
+    try {
+        std::filesystem::create_directories(directory_);
+    } catch (const std::exception& e) {
+        GAME_LOG_WARN("Shader cache disabled, cannot create " + directory_ + ": " + e.what());
+        return;
+    }
+
+    // A binary is only valid for the exact driver that produced it.
+    driver_ = getGLString(GL_VENDOR) + "|" + getGLString(GL_RENDERER) + "|" + getGLString(GL_VERSION);
+    available_ = true;
+}
+
+uint64_t ShaderCache::makeKey(const char* vertexSource, const char* fragmentSource) const {
+    uint64_t key = Utils::hashBytes(driver_.data(), driver_.size());
+    key = Utils::hashBytes(vertexSource, std::strlen(vertexSource) + 1, key);
+    return Utils::hashBytes(fragmentSource, std::strlen(fragmentSource) + 1, key);
+}
+
+std::string ShaderCache::getCachePath(uint64_t key) const {
+    return directory_ + "/" + Utils::toHex(key) + ".asbc";
+}
+
+GLuint ShaderCache::buildProgram(const std::string& name, const char* vertexSource, const char* fragmentSource) {
+    uint64_t key = 0;
+    if (available_) {
+        key = makeKey(vertexSource, fragmentSource);
+
+        GLuint program = loadBinary(name, key);
+        if (program) {
+            hits_++;
+            return program;
+        }
+    }
+
+    misses_++;
+
+    GLuint program = linkProgram(name, vertexSource, fragmentSource);
+    if (program && available_) {
+        storeBinary(name, key, program);
+    }
+
+    return program;
+}
+
+GLuint ShaderCache::compileShader(const std::string& name, GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        GLint length = 0;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+        std::string infoLog(std::max(length, 1), '\0');
+        glGetShaderInfoLog(shader, (GLsizei)infoLog.size(), nullptr, infoLog.data());
+
+        GAME_LOG_ERROR(name + (type == GL_VERTEX_SHADER ? " vertex" : " fragment") +
+                       " shader compilation failed: " + infoLog.c_str());
+        glDeleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
+
+GLuint ShaderCache::linkProgram(const std::string& name, const char* vertexSource, const char* fragmentSource) {
+    GLuint vertexShader = compileShader(name, GL_VERTEX_SHADER, vertexSource);
+    GLuint fragmentShader = vertexShader ? compileShader(name, GL_FRAGMENT_SHADER, fragmentSource) : 0;
+    if (!vertexShader || !fragmentShader) {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    if (available_) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+    glDetachShader(program, vertexShader);
+    glDetachShader(program, fragmentShader);
+
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        GLint length = 0;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+        std::string infoLog(std::max(length, 1), '\0');
+        glGetProgramInfoLog(program, (GLsizei)infoLog.size(), nullptr, infoLog.data());
+
+        GAME_LOG_ERROR(name + " program linking failed: " + infoLog.c_str());
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    return program;
+}
+
+GLuint ShaderCache::loadBinary(const std::string& name, uint64_t key) {
+    std::string cachePath = getCachePath(key);
+
+    MappedFile file;
+    if (!file.open(cachePath)) return 0;
+
+    if (file.size() < sizeof(ShaderCacheHeader)) return 0;
+
+    ShaderCacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (header.magic != SHADER_CACHE_MAGIC || header.version != SHADER_CACHE_VERSION || header.key != key ||
+        header.size == 0 || file.size() < sizeof(ShaderCacheHeader) + header.size) {
+        GAME_LOG_WARN("Corrupt shader cache entry: " + cachePath);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, (GLenum)header.format, file.data() + sizeof(ShaderCacheHeader), (GLsizei)header.size);
+
+    // Drivers are free to reject any binary, old ones in particular.
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        GAME_LOG_DEBUG("Cached " + name + " program rejected by the driver, recompiling");
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    return program;
+}
+
+void ShaderCache::storeBinary(const std::string& name, uint64_t key, GLuint program) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<unsigned char> binary((size_t)length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+    if (length <= 0) return;
+
+    ShaderCacheHeader header = {};
+    header.magic = SHADER_CACHE_MAGIC;
+    header.version = SHADER_CACHE_VERSION;
+    header.key = key;
+    header.format = (uint32_t)format;
+    header.size = (uint32_t)length;
+
+    std::string cachePath = getCachePath(key);
+    std::string tempPath = cachePath + ".tmp";
+
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            GAME_LOG_WARN("Failed to write shader cache: " + tempPath);
+            return;
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(binary.data()), length);
+
+        if (!out.good()) {
+            out.close();
+            GAME_LOG_WARN("Failed to write shader cache: " + tempPath);
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            return;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return;
+    }
+
+    GAME_LOG_DEBUG("Cached " + name + " program binary: " + cachePath);
+}
@@ -0,0 +1,103 @@
+#include <mutex>
+
+#include "system/SimulationThread.h"
+#include "system/InputQueue.h"
+#include "system/InputRecording.h"
+#include "system/ScreenshotService.h"
+#include <BaseState.h>
+
+SimulationThread::SimulationThread(AppContext* appContext, std::chrono::high_resolution_clock::time_point epoch,
+                                   int rateHz)
+    : appContext_(appContext), epoch_(epoch), rateHz_(rateHz > 0 ? rateHz : SIMULATION_RATE_HZ) {
+}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::start() {
+    if (running_.exchange(true)) return;
+    thread_ = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop() {
+    running_.store(false);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void SimulationThread::run() {
+    GAME_LOG_DEBUG("Simulation thread started at " + std::to_string(rateHz_) + "Hz");
+
+    using Clock = std::chrono::steady_clock;
+    auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rateHz_));
+    float deltaTime = 1.0f / rateHz_;
+
+    // Sleeps until the next slot instead of spinning; a 1 kHz tick costs
+    // next to no CPU. Late wakeups (coarse OS timers) are made up by
+    // running the missed ticks back to back, so the average rate holds.
+    Clock::time_point nextTick = Clock::now();
+
+    while (running_.load()) {
+        int steps = 0;
+        while (nextTick <= Clock::now() && steps < SIMULATION_MAX_CATCH_UP) {
+            double now = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - epoch_).count();
+            if (recordingOrigin_ < 0.0) {
+                recordingOrigin_ = now;
+            }
+
+            tick(now, deltaTime);
+            ticks_++;
+
+            nextTick += period;
+            steps++;
+        }
+
+        // After a long stall, drop the backlog instead of fast-forwarding.
+        if (nextTick <= Clock::now()) {
+            nextTick = Clock::now() + period;
+        }
+
+        std::this_thread::sleep_until(nextTick);
+    }
+
+    GAME_LOG_DEBUG("Simulation thread stopped");
+}
+
+void SimulationThread::tick(double timeSeconds, float deltaTime) {
+    std::lock_guard<std::mutex> lock(appContext_->stateMutex);
+    BaseState* state = appContext_->currentState;
+
+    TimedInputEvent inputEvent;
+    while (appContext_->inputQueue->dequeue(inputEvent)) {
+        auto now = std::chrono::high_resolution_clock::now();
+        double latencyMs = std::chrono::duration<double, std::milli>(now - inputEvent.timestamp).count();
+
+        if (latencyMs > 5.0) {
+            GAME_LOG_DEBUG("High input latency: " + std::to_string(latencyMs) + "ms");
+        }
+
+        if (recording_ && recordingOrigin_ >= 0.0) {
+            TimedInputEvent recorded = inputEvent;
+            recorded.timeSeconds -= recordingOrigin_;
+            recording_->record(recorded);
+        }
+
+        if (inputEvent.key == GLFW_KEY_ESCAPE && inputEvent.type == TimedInputEvent::KEY_DOWN) {
+            appContext_->appQuit = true;
+        }
+
+        if (inputEvent.key == GLFW_KEY_F12 && inputEvent.type == TimedInputEvent::KEY_DOWN && appContext_->screenshots) {
+            appContext_->screenshots->request();
+        }
+
+        if (state != nullptr) {
+            state->handleEvent(inputEvent);
+        }
+    }
+
+    if (state != nullptr) {
+        state->simulate(timeSeconds, deltaTime);
+    }
+}
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <cmath>
+
+#include "system/SpriteSheet.h"
+#include "system/TextureAtlas.h"
+#include "system/Logger.h"
+
+// Upper bound on the lookup table for very long or very uneven animations;
+// past it the step grows and lookups fall back to a short forward scan.
+static const size_t MAX_LOOKUP_ENTRIES = 4096;
+
+const TextureRegion SpriteSheet::emptyRegion_;
+
+void SpriteSheet::setGrid(const TextureRegion& region, int columns, int rows, int frameCount, float frameRate) {
+    frames_.clear();
+    durations_.clear();
+
+    if (!region.isValid() || columns <= 0 || rows <= 0) {
+        rebuildTimeline();
+        return;
+    }
+
+    int cells = columns * rows;
+    if (frameCount <= 0 || frameCount > cells) {
+        frameCount = cells;
+    }
+
+    float cellU = (region.u1 - region.u0) / columns;
+    float cellV = (region.v1 - region.v0) / rows;
+    float duration = frameRate > 0.0f ? 1.0f / frameRate : 0.0f;
+
+    frames_.reserve(frameCount);
+    durations_.reserve(frameCount);
+
+    for (int i = 0; i < frameCount; ++i) {
+        int column = i % columns;
+        int row = i / columns;
+
+        TextureRegion frame;
+        frame.textureID = region.textureID;
+        frame.u0 = region.u0 + cellU * column;
+        frame.v0 = region.v0 + cellV * row;
+        frame.u1 = frame.u0 + cellU;
+        frame.v1 = frame.v0 + cellV;
+        frame.width = region.width / columns;
+        frame.height = region.height / rows;
+
+        frames_.push_back(frame);
+        durations_.push_back(duration);
+    }
+
+    rebuildTimeline();
+}
+
+bool SpriteSheet::loadGrid(TextureAtlas* atlas, const std::string& name, const std::string& filepath,
+                           int columns, int rows, int frameCount, float frameRate) {
+    const TextureRegion* region = atlas->addImage(name, filepath);
+    if (!region) {
+        GAME_LOG_ERROR("Failed to load sprite sheet: " + filepath);
+        return false;
+    }
+
+    setGrid(*region, columns, rows, frameCount, frameRate);
+    return true;
+}
+
+void SpriteSheet::addFrame(const TextureRegion& region, float duration) {
+    if (!frames_.empty() && region.textureID != frames_.front().textureID) {
+        GAME_LOG_WARN("Sprite sheet frames on different textures will break batching");
+    }
+
+    frames_.push_back(region);
+    durations_.push_back(std::max(duration, 0.0f));
+    rebuildTimeline();
+}
+
+void SpriteSheet::setFrameRate(float frameRate) {
+    float duration = frameRate > 0.0f ? 1.0f / frameRate : 0.0f;
+    std::fill(durations_.begin(), durations_.end(), duration);
+    rebuildTimeline();
+}
+
+void SpriteSheet::setFrameDuration(size_t index, float duration) {
+    if (index >= durations_.size()) return;
+
+    durations_[index] = std::max(duration, 0.0f);
+    rebuildTimeline();
+}
+
+void SpriteSheet::rebuildTimeline() {
+    frameEnds_.resize(durations_.size());
+    lookup_.clear();
+    duration_ = 0.0f;
+
+    float shortest = 0.0f;
+    uniform_ = true;
+
+    for (size_t i = 0; i < durations_.size(); ++i) {
+        duration_ += durations_[i];
+        frameEnds_[i] = duration_;
+
+        if (durations_[i] > 0.0f && (shortest == 0.0f || durations_[i] < shortest)) {
+            shortest = durations_[i];
+        }
+        if (durations_[i] != durations_[0]) {
+            uniform_ = false;
+        }
+    }
+
+    frameRate_ = uniform_ && !durations_.empty() && durations_[0] > 0.0f ? 1.0f / durations_[0] : 0.0f;
+
+    if (uniform_ || duration_ <= 0.0f) {
+        return;
+    }
+
+    lookupStep_ = std::max(shortest, duration_ / MAX_LOOKUP_ENTRIES);
+    size_t entries = (size_t)std::ceil(duration_ / lookupStep_);
+    lookup_.resize(entries);
+
+    size_t frame = 0;
+    for (size_t i = 0; i < entries; ++i) {
+        float sliceStart = i * lookupStep_;
+        while (frame + 1 < frameEnds_.size() && frameEnds_[frame] <= sliceStart) {
+            frame++;
+        }
+        lookup_[i] = (uint32_t)frame;
+    }
+}
+
+float SpriteSheet::wrapTime(float time) const {
+    if (duration_ <= 0.0f) return 0.0f;
+
+    switch (loop_) {
+        case AnimationLoop::ONCE:
+            return std::clamp(time, 0.0f, duration_);
+        case AnimationLoop::LOOP: {
+            float t = std::fmod(time, duration_);
+            return t < 0.0f ? t + duration_ : t;
+        }
+        case AnimationLoop::PING_PONG: {
+            float period = duration_ * 2.0f;
+            float t = std::fmod(time, period);
+            if (t < 0.0f) t += period;
+            return t < duration_ ? t : period - t;
+        }
+    }
+
+    return 0.0f;
+}
+
+size_t SpriteSheet::getFrameIndex(float time) const {
+    if (frames_.empty()) return 0;
+
+    size_t last = frames_.size() - 1;
+    float t = wrapTime(time);
+
+    if (uniform_) {
+        if (frameRate_ <= 0.0f) return 0;
+        return std::min((size_t)(t * frameRate_), last);
+    }
+
+    size_t slice = std::min((size_t)(t / lookupStep_), lookup_.size() - 1);
+    size_t first = lookup_[slice];
+    size_t bound = slice + 1 < lookup_.size() ? lookup_[slice + 1] : last;
+
+    // The frame ends in this slice, or the frame the next slice starts in.
+    auto end = std::upper_bound(frameEnds_.begin() + first, frameEnds_.begin() + bound, t);
+    return (size_t)(end - frameEnds_.begin());
+}
+
+const TextureRegion& SpriteSheet::getFrame(float time) const {
+    if (frames_.empty()) return emptyRegion_;
+    return frames_[getFrameIndex(time)];
+}
+
+void SpriteSheet::draw(Renderer2D* renderer, float time, float x, float y, float width, float height,
+                       const Color& tint) const {
+    const TextureRegion& frame = getFrame(time);
+    if (!frame.isValid()) return;
+
+    renderer->drawTexture(frame, x, y, width, height, tint);
+}
@@ -0,0 +1,775 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+#include "system/Storyboard.h"
+#include "system/Logger.h"
+#include "system/TextureAtlas.h"
+#include "utils/Utils.h"
+
+#include <stb_image.h>
+
+// Expanded loops beyond this many commands are cut short.
+#define STORYBOARD_MAX_LOOP_COMMANDS 1000000
+
+namespace {
+    const float PI = 3.14159265358979f;
+
+    // Splits on commas outside double quotes; paths may contain commas.
+    std::vector<std::string> splitFields(const std::string& line) {
+        std::vector<std::string> fields;
+        std::string field;
+        bool quoted = false;
+
+        for (char c : line) {
+            if (c == '"') {
+                quoted = !quoted;
+                field += c;
+            } else if (c == ',' && !quoted) {
+                fields.push_back(Utils::trim(field));
+                field.clear();
+            } else {
+                field += c;
+            }
+        }
+
+        fields.push_back(Utils::trim(field));
+        return fields;
+    }
+
+    double parseNumber(const std::string& field, double fallback = 0.0) {
+        if (field.empty()) return fallback;
+
+        char* end = nullptr;
+        double value = std::strtod(field.c_str(), &end);
+        return end == field.c_str() ? fallback : value;
+    }
+
+    std::string parsePath(const std::string& field, const std::string& directory) {
+        std::string path = field;
+        path.erase(std::remove(path.begin(), path.end(), '"'), path.end());
+        std::replace(path.begin(), path.end(), '\\', '/');
+        return directory.empty() ? path : directory + "/" + path;
+    }
+
+    bool parseLayer(const std::string& field, StoryboardLayer& layer) {
+        static const char* names[] = { "Background", "Fail", "Pass", "Foreground", "Overlay" };
+        for (int i = 0; i < 5; ++i) {
+            if (field == names[i] || field == std::to_string(i)) {
+                layer = (StoryboardLayer)i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    StoryboardOrigin parseOrigin(const std::string& field) {
+        // Indexed by the numeric form; Custom (6) is drawn as TopLeft.
+        static const char* names[] = { "TopLeft", "Centre", "CentreLeft", "TopRight", "BottomCentre",
+                                       "TopCentre", "Custom", "CentreRight", "BottomLeft", "BottomRight" };
+        static const StoryboardOrigin origins[] = {
+            StoryboardOrigin::TOP_LEFT, StoryboardOrigin::CENTRE, StoryboardOrigin::CENTRE_LEFT,
+            StoryboardOrigin::TOP_RIGHT, StoryboardOrigin::BOTTOM_CENTRE, StoryboardOrigin::TOP_CENTRE,
+            StoryboardOrigin::TOP_LEFT, StoryboardOrigin::CENTRE_RIGHT, StoryboardOrigin::BOTTOM_LEFT,
+            StoryboardOrigin::BOTTOM_RIGHT
+        };
+
+        for (int i = 0; i < 10; ++i) {
+            if (field == names[i] || field == std::to_string(i)) {
+                return origins[i];
+            }
+        }
+        return StoryboardOrigin::TOP_LEFT;
+    }
+
+    void getOriginOffset(StoryboardOrigin origin, float& x, float& y) {
+        switch (origin) {
+        case StoryboardOrigin::TOP_LEFT:      x = 0.0f; y = 0.0f; break;
+        case StoryboardOrigin::CENTRE:        x = 0.5f; y = 0.5f; break;
+        case StoryboardOrigin::CENTRE_LEFT:   x = 0.0f; y = 0.5f; break;
+        case StoryboardOrigin::TOP_RIGHT:     x = 1.0f; y = 0.0f; break;
+        case StoryboardOrigin::BOTTOM_CENTRE: x = 0.5f; y = 1.0f; break;
+        case StoryboardOrigin::TOP_CENTRE:    x = 0.5f; y = 0.0f; break;
+        case StoryboardOrigin::CENTRE_RIGHT:  x = 1.0f; y = 0.5f; break;
+        case StoryboardOrigin::BOTTOM_LEFT:   x = 0.0f; y = 1.0f; break;
+        case StoryboardOrigin::BOTTOM_RIGHT:  x = 1.0f; y = 1.0f; break;
+        }
+    }
+
+    float bounceOut(float t) {
+        if (t < 1.0f / 2.75f) return 7.5625f * t * t;
+        if (t < 2.0f / 2.75f) { t -= 1.5f / 2.75f; return 7.5625f * t * t + 0.75f; }
+        if (t < 2.5f / 2.75f) { t -= 2.25f / 2.75f; return 7.5625f * t * t + 0.9375f; }
+        t -= 2.625f / 2.75f;
+        return 7.5625f * t * t + 0.984375f;
+    }
+
+    // The 35 osu! easings, by their numeric id.
+    float ease(int easing, float t) {
+        const float elastic = 2.0f * PI / 0.3f;
+        const float back = 1.70158f;
+        const float backInOut = back * 1.525f;
+        float u = t - 1.0f;
+
+        switch (easing) {
+        case 1:
+        case 4:  return t * (2.0f - t);
+        case 2:
+        case 3:  return t * t;
+        case 5:  return t < 0.5f ? 2.0f * t * t : 1.0f - 2.0f * u * u;
+        case 6:  return t * t * t;
+        case 7:  return u * u * u + 1.0f;
+        case 8:  return t < 0.5f ? 4.0f * t * t * t : 4.0f * u * u * u + 1.0f;
+        case 9:  return t * t * t * t;
+        case 10: return 1.0f - u * u * u * u;
+        case 11: return t < 0.5f ? 8.0f * t * t * t * t : 1.0f - 8.0f * u * u * u * u;
+        case 12: return t * t * t * t * t;
+        case 13: return u * u * u * u * u + 1.0f;
+        case 14: return t < 0.5f ? 16.0f * t * t * t * t * t : 16.0f * u * u * u * u * u + 1.0f;
+        case 15: return 1.0f - std::cos(t * PI * 0.5f);
+        case 16: return std::sin(t * PI * 0.5f);
+        case 17: return 0.5f - 0.5f * std::cos(PI * t);
+        case 18: return t <= 0.0f ? 0.0f : std::pow(2.0f, 10.0f * u);
+        case 19: return t >= 1.0f ? 1.0f : 1.0f - std::pow(2.0f, -10.0f * t);
+        case 20:
+            if (t <= 0.0f || t >= 1.0f) return t;
+            return t < 0.5f ? 0.5f * std::pow(2.0f, 20.0f * t - 10.0f)
+                            : 1.0f - 0.5f * std::pow(2.0f, -20.0f * t + 10.0f);
+        case 21: return 1.0f - std::sqrt(std::max(1.0f - t * t, 0.0f));
+        case 22: return std::sqrt(std::max(1.0f - u * u, 0.0f));
+        case 23:
+            return t < 0.5f ? 0.5f - 0.5f * std::sqrt(std::max(1.0f - 4.0f * t * t, 0.0f))
+                            : 0.5f + 0.5f * std::sqrt(std::max(1.0f - 4.0f * u * u, 0.0f));
+        case 24:
+            if (t <= 0.0f || t >= 1.0f) return t;
+            return -std::pow(2.0f, 10.0f * u) * std::sin((u - 0.075f) * elastic);
+        case 25:
+        case 26:
+        case 27: {
+            if (t <= 0.0f || t >= 1.0f) return t;
+            float period = easing == 25 ? 1.0f : (easing == 26 ? 0.5f : 0.25f);
+            return std::pow(2.0f, -10.0f * t) * std::sin((period * t - 0.075f) * elastic) + 1.0f;
+        }
+        case 28: {
+            if (t <= 0.0f || t >= 1.0f) return t;
+            float s = std::sin((20.0f * t - 11.125f) * 2.0f * PI / 4.5f);
+            return t < 0.5f ? -0.5f * std::pow(2.0f, 20.0f * t - 10.0f) * s
+                            : 0.5f * std::pow(2.0f, -20.0f * t + 10.0f) * s + 1.0f;
+        }
+        case 29: return t * t * ((back + 1.0f) * t - back);
+        case 30: return u * u * ((back + 1.0f) * u + back) + 1.0f;
+        case 31: {
+            float d = t * 2.0f;
+            if (d < 1.0f) return 0.5f * d * d * ((backInOut + 1.0f) * d - backInOut);
+            d -= 2.0f;
+            return 0.5f * (d * d * ((backInOut + 1.0f) * d + backInOut) + 2.0f);
+        }
+        case 32: return 1.0f - bounceOut(1.0f - t);
+        case 33: return bounceOut(t);
+        case 34:
+            return t < 0.5f ? 0.5f - 0.5f * bounceOut(1.0f - 2.0f * t) : 0.5f + 0.5f * bounceOut(2.0f * t - 1.0f);
+        default: return t;
+        }
+    }
+}
+
+Storyboard::~Storyboard() {
+    clear();
+}
+
+void Storyboard::clear() {
+    if (renderer_) {
+        for (GLuint texture : ownedTextures_) {
+            renderer_->unloadTexture(texture);
+        }
+    }
+    ownedTextures_.clear();
+    looseRegions_.clear();
+    renderer_ = nullptr;
+
+    sprites_.clear();
+    commands_.clear();
+    animations_.clear();
+    buckets_.clear();
+    drawList_.clear();
+    activeCount_ = 0;
+    startTime_ = 0.0;
+    endTime_ = 0.0;
+}
+
+bool Storyboard::parseFile(const std::string& path, const std::string& directory) {
+    std::string text = Utils::readFile(path);
+    if (text.empty()) {
+        GAME_LOG_ERROR("Failed to read storyboard: " + path);
+        return false;
+    }
+
+    return parse(text, directory);
+}
+
+bool Storyboard::parseObject(const std::vector<std::string>& fields, Sprite& sprite) const {
+    bool animation = fields[0] == "Animation" || fields[0] == "6";
+    if (fields.size() < (animation ? 8u : 6u)) return false;
+    if (!parseLayer(fields[1], sprite.layer)) return false;
+
+    sprite.origin = parseOrigin(fields[2]);
+    sprite.path = fields[3];
+    sprite.x = (float)parseNumber(fields[4]);
+    sprite.y = (float)parseNumber(fields[5]);
+
+    if (animation) {
+        sprite.frameCount = std::max((int)parseNumber(fields[6]), 1);
+        sprite.frameDelay = parseNumber(fields[7]);
+        sprite.loopForever = fields.size() < 9 || (fields[8] != "LoopOnce" && fields[8] != "1");
+    }
+
+    return true;
+}
+
+bool Storyboard::parseCommand(const std::vector<std::string>& fields, std::vector<ParsedCommand>& out) const {
+    if (fields.size() < 5) return false;
+
+    const std::string& type = fields[0];
+    int easing = (int)parseNumber(fields[1]);
+    double startTime = parseNumber(fields[2]);
+    double endTime = parseNumber(fields[3], startTime);
+
+    if (type == "P") {
+        StoryboardTrack track;
+        if (fields[4] == "H") track = StoryboardTrack::FLIP_H;
+        else if (fields[4] == "V") track = StoryboardTrack::FLIP_V;
+        else if (fields[4] == "A") track = StoryboardTrack::ADDITIVE;
+        else return false;
+
+        out.push_back({ track, { startTime, endTime, 1.0f, 1.0f, easing } });
+        return true;
+    }
+
+    StoryboardTrack tracks[3];
+    int componentCount = 1;
+    float valueScale = 1.0f;
+
+    if (type == "F") {
+        tracks[0] = StoryboardTrack::ALPHA;
+    } else if (type == "M") {
+        tracks[0] = StoryboardTrack::X;
+        tracks[1] = StoryboardTrack::Y;
+        componentCount = 2;
+    } else if (type == "MX") {
+        tracks[0] = StoryboardTrack::X;
+    } else if (type == "MY") {
+        tracks[0] = StoryboardTrack::Y;
+    } else if (type == "S") {
+        tracks[0] = StoryboardTrack::SCALE;
+    } else if (type == "V") {
+        tracks[0] = StoryboardTrack::SCALE_X;
+        tracks[1] = StoryboardTrack::SCALE_Y;
+        componentCount = 2;
+    } else if (type == "R") {
+        tracks[0] = StoryboardTrack::ROTATION;
+    } else if (type == "C") {
+        tracks[0] = StoryboardTrack::RED;
+        tracks[1] = StoryboardTrack::GREEN;
+        tracks[2] = StoryboardTrack::BLUE;
+        componentCount = 3;
+        valueScale = 1.0f / 255.0f;
+    } else {
+        return false;
+    }
+
+    std::vector<float> values;
+    for (size_t i = 4; i < fields.size(); ++i) {
+        if (fields[i].empty()) continue;
+        values.push_back((float)parseNumber(fields[i]) * valueScale);
+    }
+
+    size_t sets = values.size() / componentCount;
+    if (sets == 0) return false;
+
+    // Extra value sets chain further segments of the same length.
+    double duration = endTime - startTime;
+    size_t segments = std::max(sets - 1, (size_t)1);
+
+    for (size_t s = 0; s < segments; ++s) {
+        size_t to = sets > 1 ? s + 1 : s;
+        for (int k = 0; k < componentCount; ++k) {
+            out.push_back({ tracks[k], { startTime + s * duration, endTime + s * duration,
+                                         values[s * componentCount + k], values[to * componentCount + k],
+                                         easing } });
+        }
+    }
+
+    return true;
+}
+
+void Storyboard::compileSprite(Sprite& sprite, std::vector<ParsedCommand>& commands) {
+    // Grouped by track, each track sorted by start time; stable so equal
+    // start times keep their file order.
+    std::stable_sort(commands.begin(), commands.end(), [](const ParsedCommand& a, const ParsedCommand& b) {
+        if (a.track != b.track) return a.track < b.track;
+        return a.command.startTime < b.command.startTime;
+    });
+
+    sprite.startTime = commands.front().command.startTime;
+    sprite.endTime = commands.front().command.endTime;
+
+    for (const auto& parsed : commands) {
+        Track& track = sprite.tracks[(int)parsed.track];
+        if (track.count == 0) {
+            track.first = (uint32_t)commands_.size();
+        }
+        track.count++;
+
+        commands_.push_back(parsed.command);
+        sprite.startTime = std::min(sprite.startTime, parsed.command.startTime);
+        sprite.endTime = std::max(sprite.endTime, parsed.command.endTime);
+    }
+
+    sprites_.push_back(sprite);
+}
+
+bool Storyboard::parse(const std::string& text, const std::string& directory) {
+    clear();
+
+    enum class Group {
+        NONE,
+        LOOP,
+        TRIGGER
+    };
+
+    std::vector<std::pair<std::string, std::string>> variables;
+    std::string section;
+
+    Sprite sprite;
+    bool inSprite = false;
+    std::vector<ParsedCommand> spriteCommands;
+
+    Group group = Group::NONE;
+    double loopStart = 0.0;
+    int loopCount = 1;
+    std::vector<ParsedCommand> loopCommands;
+
+    size_t skippedTriggers = 0;
+    size_t skippedLines = 0;
+
+    // Loops are unrolled here: iterations follow each other with the span
+    // of the loop's commands, relative to the loop's start time.
+    auto finishGroup = [&]() {
+        if (group == Group::LOOP && !loopCommands.empty()) {
+            double first = loopCommands.front().command.startTime;
+            double last = loopCommands.front().command.endTime;
+            for (const auto& parsed : loopCommands) {
+                first = std::min(first, parsed.command.startTime);
+                last = std::max(last, parsed.command.endTime);
+            }
+
+            double duration = last - first;
+            size_t iterations = duration > 0.0 ? (size_t)std::max(loopCount, 1) : 1;
+            size_t limit = STORYBOARD_MAX_LOOP_COMMANDS / loopCommands.size();
+            if (iterations > limit) {
+                GAME_LOG_WARN("Storyboard loop cut to " + std::to_string(limit) + " of " +
+                              std::to_string(iterations) + " iterations");
+                iterations = std::max(limit, (size_t)1);
+            }
+
+            for (size_t i = 0; i < iterations; ++i) {
+                double offset = loopStart + i * duration;
+                for (ParsedCommand parsed : loopCommands) {
+                    parsed.command.startTime += offset;
+                    parsed.command.endTime += offset;
+                    spriteCommands.push_back(parsed);
+                }
+            }
+        }
+
+        group = Group::NONE;
+        loopCommands.clear();
+    };
+
+    // Sprites without commands are never visible and are dropped.
+    auto finishSprite = [&]() {
+        finishGroup();
+        if (inSprite && !spriteCommands.empty()) {
+            sprite.path = parsePath(sprite.path, directory);
+            compileSprite(sprite, spriteCommands);
+        }
+
+        inSprite = false;
+        spriteCommands.clear();
+    };
+
+    std::istringstream stream(text);
+    std::string line;
+
+    while (std::getline(stream, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        if (line.empty() || line.compare(0, 2, "//") == 0) continue;
+
+        if (line[0] == '[') {
+            finishSprite();
+            section = Utils::trim(line);
+            continue;
+        }
+
+        if (section == "[Variables]") {
+            size_t equals = line.find('=');
+            if (line[0] == '$' && equals != std::string::npos) {
+                variables.push_back({ line.substr(0, equals), Utils::trim(line.substr(equals + 1)) });
+
+                // Longest first, so $a never replaces the start of $ab.
+                std::stable_sort(variables.begin(), variables.end(), [](const auto& a, const auto& b) {
+                    return a.first.size() > b.first.size();
+                });
+            }
+            continue;
+        }
+
+        if (section != "[Events]") continue;
+
+        if (!variables.empty() && line.find('$') != std::string::npos) {
+            for (const auto& variable : variables) {
+                // Search on past the inserted value, which may contain the
+                // variable's own name.
+                size_t pos = 0;
+                while ((pos = line.find(variable.first, pos)) != std::string::npos) {
+                    line.replace(pos, variable.first.size(), variable.second);
+                    pos += variable.second.size();
+                }
+            }
+        }
+
+        size_t depth = 0;
+        while (depth < line.size() && (line[depth] == ' ' || line[depth] == '_')) {
+            depth++;
+        }
+
+        std::vector<std::string> fields = splitFields(line.substr(depth));
+        if (fields.empty() || fields[0].empty()) continue;
+
+        if (depth == 0) {
+            finishSprite();
+
+            // Backgrounds, videos, breaks and samples are not storyboard
+            // sprites.
+            if (fields[0] == "Sprite" || fields[0] == "4" || fields[0] == "Animation" || fields[0] == "6") {
+                sprite = Sprite();
+                inSprite = parseObject(fields, sprite);
+                if (!inSprite) skippedLines++;
+            }
+            continue;
+        }
+
+        if (!inSprite) continue;
+
+        if (depth == 1 || group == Group::NONE) {
+            finishGroup();
+
+            if (fields[0] == "L") {
+                if (fields.size() < 3) {
+                    skippedLines++;
+                    continue;
+                }
+                group = Group::LOOP;
+                loopStart = parseNumber(fields[1]);
+                loopCount = (int)parseNumber(fields[2], 1.0);
+            } else if (fields[0] == "T") {
+                group = Group::TRIGGER;
+                skippedTriggers++;
+            } else if (!parseCommand(fields, spriteCommands)) {
+                skippedLines++;
+            }
+        } else if (group == Group::LOOP) {
+            if (!parseCommand(fields, loopCommands)) {
+                skippedLines++;
+            }
+        }
+    }
+
+    finishSprite();
+
+    // Layers draw bottom to top, sprites within a layer in file order.
+    std::stable_sort(sprites_.begin(), sprites_.end(), [](const Sprite& a, const Sprite& b) {
+        return a.layer < b.layer;
+    });
+
+    buildIndex();
+
+    if (skippedLines > 0) {
+        GAME_LOG_WARN("Skipped " + std::to_string(skippedLines) + " malformed storyboard lines");
+    }
+    if (skippedTriggers > 0) {
+        GAME_LOG_DEBUG("Ignored " + std::to_string(skippedTriggers) + " storyboard trigger groups");
+    }
+
+    GAME_LOG_INFO("Parsed storyboard: " + std::to_string(sprites_.size()) + " sprites, " +
+                  std::to_string(commands_.size()) + " commands, " + std::to_string(buckets_.size()) +
+                  " time buckets");
+    return true;
+}
+
+void Storyboard::buildIndex() {
+    buckets_.clear();
+    if (sprites_.empty()) return;
+
+    startTime_ = sprites_[0].startTime;
+    endTime_ = sprites_[0].endTime;
+    for (const auto& sprite : sprites_) {
+        startTime_ = std::min(startTime_, sprite.startTime);
+        endTime_ = std::max(endTime_, sprite.endTime);
+    }
+
+    double span = endTime_ - startTime_;
+    bucketMs_ = std::max(STORYBOARD_BUCKET_MS, span / STORYBOARD_MAX_BUCKETS);
+    buckets_.resize((size_t)(span / bucketMs_) + 1);
+
+    // Pushed in sprite order, so every bucket is already in draw order.
+    for (uint32_t i = 0; i < (uint32_t)sprites_.size(); ++i) {
+        size_t first = (size_t)((sprites_[i].startTime - startTime_) / bucketMs_);
+        size_t last = std::min((size_t)((sprites_[i].endTime - startTime_) / bucketMs_), buckets_.size() - 1);
+
+        for (size_t b = first; b <= last; ++b) {
+            buckets_[b].push_back(i);
+        }
+    }
+}
+
+const TextureRegion* Storyboard::loadImage(const std::string& path, TextureAtlas* atlas, Renderer2D* renderer) {
+    auto it = looseRegions_.find(path);
+    if (it != looseRegions_.end()) {
+        return it->second.isValid() ? &it->second : nullptr;
+    }
+
+    if (atlas && atlas->hasRegion(path)) {
+        return atlas->getRegion(path);
+    }
+
+    int width, height, channels;
+    if (!stbi_info(path.c_str(), &width, &height, &channels)) {
+        GAME_LOG_WARN("Missing storyboard image: " + path);
+        looseRegions_[path] = TextureRegion();
+        return nullptr;
+    }
+
+    if (atlas && width <= STORYBOARD_ATLAS_MAX_SIZE && height <= STORYBOARD_ATLAS_MAX_SIZE) {
+        if (const TextureRegion* region = atlas->addImage(path, path)) {
+            return region;
+        }
+    }
+
+    TextureRegion region;
+    region.textureID = renderer->loadTexture(path, false);
+    region.width = width;
+    region.height = height;
+
+    if (region.textureID) {
+        ownedTextures_.push_back(region.textureID);
+    }
+
+    auto result = looseRegions_.emplace(path, region);
+    return region.isValid() ? &result.first->second : nullptr;
+}
+
+void Storyboard::loadTextures(TextureAtlas* atlas, Renderer2D* renderer) {
+    renderer_ = renderer;
+
+    for (auto& sprite : sprites_) {
+        if (sprite.frameCount == 0) {
+            if (const TextureRegion* region = loadImage(sprite.path, atlas, renderer)) {
+                sprite.region = *region;
+            }
+            continue;
+        }
+
+        // Frames are numbered before the extension: name0.png, name1.png...
+        size_t dot = sprite.path.find_last_of('.');
+        size_t slash = sprite.path.find_last_of('/');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+            dot = sprite.path.size();
+        }
+
+        SpriteSheet sheet;
+        for (int frame = 0; frame < sprite.frameCount; ++frame) {
+            std::string framePath = sprite.path.substr(0, dot) + std::to_string(frame) + sprite.path.substr(dot);
+            if (const TextureRegion* region = loadImage(framePath, atlas, renderer)) {
+                sheet.addFrame(*region, (float)(sprite.frameDelay / 1000.0));
+            }
+        }
+
+        if (sheet.getFrameCount() > 0) {
+            sheet.setLoop(sprite.loopForever ? AnimationLoop::LOOP : AnimationLoop::ONCE);
+            sprite.animation = (int)animations_.size();
+            sprite.region = sheet.getFrame(0.0f);
+            animations_.push_back(std::move(sheet));
+        }
+    }
+
+    GAME_LOG_INFO("Loaded storyboard textures: " + std::to_string(atlas ? atlas->getPageCount() : 0) +
+                  " atlas pages, " + std::to_string(ownedTextures_.size()) + " separate");
+}
+
+float Storyboard::evaluate(const Sprite& sprite, StoryboardTrack track, double time, float defaultValue) const {
+    const Track& range = sprite.tracks[(int)track];
+    if (range.count == 0) return defaultValue;
+
+    const StoryboardCommand* first = commands_.data() + range.first;
+    const StoryboardCommand* last = first + range.count;
+
+    // The latest command that has started; before the first one, its
+    // start value holds.
+    const StoryboardCommand* command = std::upper_bound(first, last, time,
+        [](double t, const StoryboardCommand& c) { return t < c.startTime; });
+    if (command == first) return first->startValue;
+    --command;
+
+    if (time >= command->endTime) return command->endValue;
+
+    float progress = (float)((time - command->startTime) / (command->endTime - command->startTime));
+    return command->startValue + (command->endValue - command->startValue) * ease(command->easing, progress);
+}
+
+bool Storyboard::evaluateFlag(const Sprite& sprite, StoryboardTrack track, double time) const {
+    const Track& range = sprite.tracks[(int)track];
+    if (range.count == 0) return false;
+
+    const StoryboardCommand* first = commands_.data() + range.first;
+    const StoryboardCommand* last = first + range.count;
+
+    const StoryboardCommand* command = std::upper_bound(first, last, time,
+        [](double t, const StoryboardCommand& c) { return t < c.startTime; });
+    if (command == first) return false;
+    --command;
+
+    // A parameter with no duration stays on for good.
+    return command->startTime == command->endTime || time < command->endTime;
+}
+
+void Storyboard::evaluateSprite(const Sprite& sprite, double time, float scale, float offsetX, float width,
+                                float height) {
+    float alpha = evaluate(sprite, StoryboardTrack::ALPHA, time, 1.0f);
+    if (alpha <= 0.0f) return;
+
+    TextureRegion region = sprite.region;
+    if (sprite.animation >= 0) {
+        region = animations_[sprite.animation].getFrame((float)((time - sprite.startTime) / 1000.0));
+    }
+    if (!region.isValid()) return;
+
+    float uniformScale = evaluate(sprite, StoryboardTrack::SCALE, time, 1.0f);
+    float scaleX = uniformScale * evaluate(sprite, StoryboardTrack::SCALE_X, time, 1.0f);
+    float scaleY = uniformScale * evaluate(sprite, StoryboardTrack::SCALE_Y, time, 1.0f);
+    if (scaleX == 0.0f || scaleY == 0.0f) return;
+
+    DrawItem item;
+    item.region = region;
+    item.flipH = evaluateFlag(sprite, StoryboardTrack::FLIP_H, time);
+    item.flipV = evaluateFlag(sprite, StoryboardTrack::FLIP_V, time);
+    item.additive = evaluateFlag(sprite, StoryboardTrack::ADDITIVE, time);
+
+    // Flipping mirrors the sprite around its origin.
+    float originX, originY;
+    getOriginOffset(sprite.origin, originX, originY);
+    if (item.flipH) originX = 1.0f - originX;
+    if (item.flipV) originY = 1.0f - originY;
+
+    float w = region.width * scaleX * scale;
+    float h = region.height * scaleY * scale;
+    float left = -originX * w, right = (1.0f - originX) * w;
+    float top = -originY * h, bottom = (1.0f - originY) * h;
+
+    float x = offsetX + evaluate(sprite, StoryboardTrack::X, time, sprite.x) * scale;
+    float y = evaluate(sprite, StoryboardTrack::Y, time, sprite.y) * scale;
+
+    // Clockwise on screen, y pointing down.
+    float rotation = evaluate(sprite, StoryboardTrack::ROTATION, time, 0.0f);
+    float c = std::cos(rotation), s = std::sin(rotation);
+
+    const float local[8] = { left, top, right, top, right, bottom, left, bottom };
+    float minX = x, maxX = x, minY = y, maxY = y;
+    for (int i = 0; i < 4; ++i) {
+        float px = x + local[i * 2] * c - local[i * 2 + 1] * s;
+        float py = y + local[i * 2] * s + local[i * 2 + 1] * c;
+        item.corners[i * 2] = px;
+        item.corners[i * 2 + 1] = py;
+
+        minX = std::min(minX, px);
+        maxX = std::max(maxX, px);
+        minY = std::min(minY, py);
+        maxY = std::max(maxY, py);
+    }
+
+    if (maxX < 0.0f || minX > width || maxY < 0.0f || minY > height) return;
+
+    item.color = Color(evaluate(sprite, StoryboardTrack::RED, time, 1.0f),
+                       evaluate(sprite, StoryboardTrack::GREEN, time, 1.0f),
+                       evaluate(sprite, StoryboardTrack::BLUE, time, 1.0f),
+                       std::min(alpha, 1.0f));
+
+    drawList_.push_back(item);
+}
+
+void Storyboard::update(double timeMs, float width, float height) {
+    drawList_.clear();
+    activeCount_ = 0;
+
+    if (buckets_.empty() || timeMs < startTime_ || timeMs > endTime_) return;
+
+    size_t bucket = std::min((size_t)((timeMs - startTime_) / bucketMs_), buckets_.size() - 1);
+
+    float scale = height / STORYBOARD_HEIGHT;
+    float offsetX = (width - STORYBOARD_WIDTH * scale) * 0.5f;
+
+    for (uint32_t index : buckets_[bucket]) {
+        const Sprite& sprite = sprites_[index];
+        if (timeMs < sprite.startTime || timeMs > sprite.endTime) continue;
+
+        if ((sprite.layer == StoryboardLayer::FAIL && passing_) ||
+            (sprite.layer == StoryboardLayer::PASS && !passing_)) {
+            continue;
+        }
+
+        activeCount_++;
+        evaluateSprite(sprite, timeMs, scale, offsetX, width, height);
+    }
+}
+
+void Storyboard::render(Renderer2D* renderer) const {
+    if (drawList_.empty()) return;
+
+    renderer->beginBatch();
+
+    bool additive = false;
+    for (const auto& item : drawList_) {
+        // Blending is global state, so additive runs are flushed apart.
+        if (item.additive != additive) {
+            renderer->flush();
+            glBlendFunc(GL_SRC_ALPHA, item.additive ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+            additive = item.additive;
+        }
+
+        BatchVertex* out;
+        if (renderer->allocateQuads(item.region.textureID, 1, out) == 0) continue;
+
+        float u0 = item.flipH ? item.region.u1 : item.region.u0;
+        float u1 = item.flipH ? item.region.u0 : item.region.u1;
+        float v0 = item.flipV ? item.region.v1 : item.region.v0;
+        float v1 = item.flipV ? item.region.v0 : item.region.v1;
+        const Color& color = item.color;
+        const float* p = item.corners;
+
+        out[0] = { p[0], p[1], u0, v0, color.r, color.g, color.b, color.a };
+        out[1] = { p[2], p[3], u1, v0, color.r, color.g, color.b, color.a };
+        out[2] = { p[4], p[5], u1, v1, color.r, color.g, color.b, color.a };
+        out[3] = { p[6], p[7], u0, v1, color.r, color.g, color.b, color.a };
+    }
+
+    if (additive) {
+        renderer->flush();
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+
+    renderer->endBatch();
+}
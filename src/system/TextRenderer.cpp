@@ -1,6 +1,8 @@
 #include "system/TextRenderer.h"
 #include "system/Logger.h"
-#include <iostream>
+#include "system/GLState.h"
+#include "system/ShaderCache.h"
+#include "system/Renderer2D.h"
 #include <vector>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -8,7 +10,9 @@ const char* textVertexShaderSource = R"(
 #version 330 core
 layout (location = 0) in vec4 vertex;
 out vec2 TexCoords;
-uniform mat4 projection;
+layout (std140) uniform Projection {
+    mat4 projection;
+};
 void main() {
     gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
     TexCoords = vertex.zw;
@@ -32,11 +36,11 @@ TextRenderer::TextRenderer(int screenWidth, int screenHeight)
       shaderProgram_(0), VAO_(0), VBO_(0) {
     
     if (!initFreeType()) {
-        std::cerr << "Failed to initialize FreeType" << std::endl;
+        GAME_LOG_ERROR("Failed to initialize FreeType");
     }
     
     if (!compileShaders()) {
-        std::cerr << "Failed to compile text shaders" << std::endl;
+        GAME_LOG_ERROR("Failed to compile text shaders");
     }
     
     setupBuffers();
@@ -46,7 +50,7 @@ TextRenderer::TextRenderer(int screenWidth, int screenHeight)
 TextRenderer::~TextRenderer() {
     for (auto& pair : fonts_) {
         for (auto& charPair : pair.second.characters) {
-            glDeleteTextures(1, &charPair.second.textureID);
+            GLState::getInstance().deleteTexture(charPair.second.textureID);
         }
         if (pair.second.face) {
             FT_Done_Face(pair.second.face);
@@ -54,15 +58,16 @@ TextRenderer::~TextRenderer() {
     }
     fonts_.clear();
     
-    if (VAO_) glDeleteVertexArrays(1, &VAO_);
-    if (VBO_) glDeleteBuffers(1, &VBO_);
-    if (shaderProgram_) glDeleteProgram(shaderProgram_);
+    GLState& gl = GLState::getInstance();
+    gl.deleteVertexArray(VAO_);
+    gl.deleteBuffer(VBO_);
+    gl.deleteProgram(shaderProgram_);
     if (ft_) FT_Done_FreeType(ft_);
 }
 
 bool TextRenderer::initFreeType() {
     if (FT_Init_FreeType(&ft_)) {
-        std::cerr << "Could not init FreeType Library" << std::endl;
+        GAME_LOG_ERROR("Could not init FreeType Library");
         return false;
     }
     return true;
@@ -94,13 +99,13 @@ bool TextRenderer::loadFont(const std::string& fontPath, int fontSize) {
     
     for (unsigned char c = 0; c < 128; c++) {
         if (FT_Load_Char(fontData.face, c, FT_LOAD_RENDER)) {
-            std::cerr << "Failed to load glyph: " << c << std::endl;
+            GAME_LOG_ERROR("Failed to load glyph " + std::to_string((int)c) + " from " + fontPath);
             continue;
         }
         
         GLuint texture;
         glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
+        GLState::getInstance().bindTexture(0, texture);
         glTexImage2D(
             GL_TEXTURE_2D, 0, GL_RED,
             fontData.face->glyph->bitmap.width,
@@ -124,8 +129,6 @@ bool TextRenderer::loadFont(const std::string& fontPath, int fontSize) {
         fontData.characters.insert(std::pair<char, Character>(c, character));
     }
     
-    glBindTexture(GL_TEXTURE_2D, 0);
-    
     fonts_[key] = fontData;
     GAME_LOG_DEBUG("Font loaded successfully: " + fontPath + " size " + std::to_string(fontSize));
     
@@ -147,67 +150,40 @@ FontData* TextRenderer::getFontData(const std::string& fontPath, int fontSize) {
 }
 
 bool TextRenderer::compileShaders() {
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &textVertexShaderSource, nullptr);
-    glCompileShader(vertexShader);
-    
-    GLint success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
-        std::cerr << "Text Vertex Shader Failed:\n" << infoLog << std::endl;
+    shaderProgram_ = ShaderCache::getInstance().buildProgram("Text", textVertexShaderSource, textFragmentShaderSource);
+    if (!shaderProgram_) {
         return false;
     }
     
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &textFragmentShaderSource, nullptr);
-    glCompileShader(fragmentShader);
-    
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
-        std::cerr << "Text Fragment Shader Failed:\n" << infoLog << std::endl;
-        return false;
-    }
-    
-    shaderProgram_ = glCreateProgram();
-    glAttachShader(shaderProgram_, vertexShader);
-    glAttachShader(shaderProgram_, fragmentShader);
-    glLinkProgram(shaderProgram_);
-    
-    glGetProgramiv(shaderProgram_, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram_, 512, nullptr, infoLog);
-        std::cerr << "Text Shader Linking Failed:\n" << infoLog << std::endl;
-        return false;
-    }
-    
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    GLState& gl = GLState::getInstance();
+    gl.attachProjectionBlock(shaderProgram_);
+    gl.useProgram(shaderProgram_);
+    glUniform1i(gl.getUniformLocation(shaderProgram_, "text"), 0);
     
     return true;
 }
 
 void TextRenderer::setupBuffers() {
+    GLState& gl = GLState::getInstance();
+    
     glGenVertexArrays(1, &VAO_);
     glGenBuffers(1, &VBO_);
     
-    glBindVertexArray(VAO_);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO_);
+    gl.bindVertexArray(VAO_);
+    gl.bindBuffer(GL_ARRAY_BUFFER, VBO_);
     glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
     
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    gl.bindVertexArray(0);
 }
 
 void TextRenderer::setViewport(int width, int height) {
     screenWidth_ = width;
     screenHeight_ = height;
-    projection_ = glm::ortho(0.0f, (float)width, (float)height, 0.0f);
+    projection_ = glm::ortho(0.0f, (float)width, (float)height, 0.0f, -1.0f, 1.0f);
+    GLState::getInstance().setProjection(projection_);
 }
 
 void TextRenderer::renderText(const std::string& text, float x, float y, float scale, 
@@ -218,13 +194,18 @@ void TextRenderer::renderText(const std::string& text, float x, float y, float s
         GAME_LOG_ERROR("Font not loaded: " + fontPath);
         return;
     }
+
+    if (batchRenderer_) {
+        batchRenderer_->flush();
+    }
     
-    glUseProgram(shaderProgram_);
-    glUniform4f(glGetUniformLocation(shaderProgram_, "textColor"), color.x, color.y, color.z, color.w);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram_, "projection"), 1, GL_FALSE, &projection_[0][0]);
+    GLState& gl = GLState::getInstance();
+    gl.setProjection(projection_);
+    gl.useProgram(shaderProgram_);
+    glUniform4f(gl.getUniformLocation(shaderProgram_, "textColor"), color.x, color.y, color.z, color.w);
     
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(VAO_);
+    gl.bindVertexArray(VAO_);
+    gl.bindBuffer(GL_ARRAY_BUFFER, VBO_);
     
     std::vector<float> lineWidths;
     if (alignment != TEXT_ALIGN_LEFT) {
@@ -291,18 +272,13 @@ void TextRenderer::renderText(const std::string& text, float x, float y, float s
             { xpos + w, ypos + h,   1.0f, 1.0f }
         };
         
-        glBindTexture(GL_TEXTURE_2D, ch.textureID);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO_);
+        gl.bindTexture(0, ch.textureID);
         glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
         
         glDrawArrays(GL_TRIANGLES, 0, 6);
         
         x += (ch.advance >> 6) * scale;
     }
-    
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void TextRenderer::getTextSize(const std::string& text, float scale, float& width, float& height,
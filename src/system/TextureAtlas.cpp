@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <climits>
+
+#include "system/TextureAtlas.h"
+#include "system/GLState.h"
+#include "system/Logger.h"
+
+#include <stb_image.h>
+
+SkylinePacker::SkylinePacker(int width, int height) {
+    reset(width, height);
+}
+
+void SkylinePacker::reset(int width, int height) {
+    width_ = width;
+    height_ = height;
+    usedArea_ = 0;
+
+    skyline_.clear();
+    if (width > 0) {
+        skyline_.push_back({ 0, 0, width });
+    }
+}
+
+bool SkylinePacker::fits(size_t index, int width, int height, int& outY) const {
+    int x = skyline_[index].x;
+    if (x + width > width_) {
+        return false;
+    }
+
+    int remaining = width;
+    int y = skyline_[index].y;
+
+    for (size_t i = index; remaining > 0; ++i) {
+        if (i >= skyline_.size()) return false;
+
+        y = std::max(y, skyline_[i].y);
+        if (y + height > height_) return false;
+
+        remaining -= skyline_[i].width;
+    }
+
+    outY = y;
+    return true;
+}
+
+bool SkylinePacker::pack(int width, int height, int& outX, int& outY) {
+    int bestBottom = INT_MAX;
+    int bestWidth = INT_MAX;
+    size_t bestIndex = skyline_.size();
+
+    for (size_t i = 0; i < skyline_.size(); ++i) {
+        int y;
+        if (!fits(i, width, height, y)) continue;
+
+        int bottom = y + height;
+        if (bottom < bestBottom || (bottom == bestBottom && skyline_[i].width < bestWidth)) {
+            bestBottom = bottom;
+            bestWidth = skyline_[i].width;
+            bestIndex = i;
+            outX = skyline_[i].x;
+            outY = y;
+        }
+    }
+
+    if (bestIndex == skyline_.size()) {
+        return false;
+    }
+
+    addSegment(bestIndex, outX, outY, width, height);
+    usedArea_ += (long)width * height;
+    return true;
+}
+
+void SkylinePacker::addSegment(size_t index, int x, int y, int width, int height) {
+    skyline_.insert(skyline_.begin() + index, { x, y + height, width });
+
+    // Trim or drop everything the new segment now covers.
+    for (size_t i = index + 1; i < skyline_.size(); ) {
+        Segment& prev = skyline_[i - 1];
+        Segment& seg = skyline_[i];
+
+        int prevRight = prev.x + prev.width;
+        if (seg.x >= prevRight) break;
+
+        int shrink = prevRight - seg.x;
+        seg.x += shrink;
+        seg.width -= shrink;
+
+        if (seg.width <= 0) {
+            skyline_.erase(skyline_.begin() + i);
+        } else {
+            break;
+        }
+    }
+
+    for (size_t i = 0; i + 1 < skyline_.size(); ) {
+        if (skyline_[i].y == skyline_[i + 1].y) {
+            skyline_[i].width += skyline_[i + 1].width;
+            skyline_.erase(skyline_.begin() + i + 1);
+        } else {
+            ++i;
+        }
+    }
+}
+
+float SkylinePacker::getOccupancy() const {
+    if (width_ <= 0 || height_ <= 0) return 0.0f;
+    return (float)usedArea_ / ((float)width_ * (float)height_);
+}
+
+TextureAtlas::TextureAtlas(int pageWidth, int pageHeight, int padding)
+    : pageWidth_(pageWidth), pageHeight_(pageHeight), padding_(padding) {
+}
+
+TextureAtlas::~TextureAtlas() {
+    clear();
+}
+
+void TextureAtlas::clear() {
+    for (auto& page : pages_) {
+        GLState::getInstance().deleteTexture(page.textureID);
+    }
+
+    pages_.clear();
+    regions_.clear();
+}
+
+TextureAtlas::Page& TextureAtlas::createPage() {
+    Page page;
+    page.packer.reset(pageWidth_, pageHeight_);
+
+    glGenTextures(1, &page.textureID);
+    GLState::getInstance().bindTexture(0, page.textureID);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, pageWidth_, pageHeight_, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    pages_.push_back(page);
+    GAME_LOG_DEBUG("Created atlas page " + std::to_string(pages_.size()) + " (" +
+                   std::to_string(pageWidth_) + "x" + std::to_string(pageHeight_) + ")");
+
+    return pages_.back();
+}
+
+const TextureRegion* TextureAtlas::addImage(const std::string& name, const std::string& filepath) {
+    if (const TextureRegion* existing = getRegion(name)) {
+        return existing;
+    }
+
+    stbi_set_flip_vertically_on_load_thread(false);
+
+    int width, height, channels;
+    unsigned char* data = stbi_load(filepath.c_str(), &width, &height, &channels, 4);
+    if (!data) {
+        GAME_LOG_ERROR("Failed to load atlas image: " + filepath);
+        return nullptr;
+    }
+
+    const TextureRegion* region = addPixels(name, data, width, height);
+    stbi_image_free(data);
+
+    return region;
+}
+
+const TextureRegion* TextureAtlas::addPixels(const std::string& name, const unsigned char* rgba, int width, int height) {
+    if (const TextureRegion* existing = getRegion(name)) {
+        return existing;
+    }
+
+    int paddedWidth = width + padding_ * 2;
+    int paddedHeight = height + padding_ * 2;
+
+    if (!rgba || width <= 0 || height <= 0 || paddedWidth > pageWidth_ || paddedHeight > pageHeight_) {
+        GAME_LOG_ERROR("Image does not fit in an atlas page: " + name + " (" +
+                       std::to_string(width) + "x" + std::to_string(height) + ")");
+        return nullptr;
+    }
+
+    Page* target = nullptr;
+    int x = 0, y = 0;
+
+    for (auto& page : pages_) {
+        if (page.packer.pack(paddedWidth, paddedHeight, x, y)) {
+            target = &page;
+            break;
+        }
+    }
+
+    if (!target) {
+        target = &createPage();
+        if (!target->packer.pack(paddedWidth, paddedHeight, x, y)) {
+            return nullptr;
+        }
+    }
+
+    // Extrude the edge pixels into the padding so linear filtering at the
+    // region border never picks up a neighbour.
+    std::vector<unsigned char> padded((size_t)paddedWidth * paddedHeight * 4);
+    for (int py = 0; py < paddedHeight; ++py) {
+        int sy = std::clamp(py - padding_, 0, height - 1);
+        for (int px = 0; px < paddedWidth; ++px) {
+            int sx = std::clamp(px - padding_, 0, width - 1);
+            const unsigned char* src = rgba + ((size_t)sy * width + sx) * 4;
+            unsigned char* dst = padded.data() + ((size_t)py * paddedWidth + px) * 4;
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = src[3];
+        }
+    }
+
+    GLState::getInstance().bindTexture(0, target->textureID);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, paddedWidth, paddedHeight, GL_RGBA, GL_UNSIGNED_BYTE, padded.data());
+
+    TextureRegion region;
+    region.textureID = target->textureID;
+    region.u0 = (float)(x + padding_) / pageWidth_;
+    region.v0 = (float)(y + padding_) / pageHeight_;
+    region.u1 = (float)(x + padding_ + width) / pageWidth_;
+    region.v1 = (float)(y + padding_ + height) / pageHeight_;
+    region.width = width;
+    region.height = height;
+
+    auto result = regions_.emplace(name, region);
+    return &result.first->second;
+}
+
+const TextureRegion* TextureAtlas::getRegion(const std::string& name) const {
+    auto it = regions_.find(name);
+    return it != regions_.end() ? &it->second : nullptr;
+}
@@ -0,0 +1,137 @@
+#include "system/TextureCache.h"
+#include "system/Logger.h"
+#include "utils/Utils.h"
+
+TextureCache::TextureCache(TextureLoader* loader, size_t budgetBytes)
+    : loader_(loader), budgetBytes_(budgetBytes) {
+}
+
+TextureCache::~TextureCache() {
+    clear();
+}
+
+std::string TextureCache::makeKey(const std::string& filepath, bool flipVertically,
+                                  const TextureImportOptions& import) {
+    return filepath + (flipVertically ? "|flip" : "|noflip") + import.getKey();
+}
+
+size_t TextureCache::getTextureBytes(const AsyncTexture& texture) {
+    return texture.isResident() ? texture.gpuBytes : 0;
+}
+
+TextureHandle TextureCache::acquire(const std::string& filepath, bool flipVertically,
+                                    const TextureImportOptions& import) {
+    std::string key = makeKey(filepath, flipVertically, import);
+
+    auto it = entries_.find(key);
+    if (it != entries_.end() && it->second.references == 0 &&
+        it->second.handle->state.load() == TextureState::FAILED) {
+        // Failed after it was released; retry rather than hand out the failure.
+        evict(it);
+        it = entries_.end();
+    }
+
+    if (it != entries_.end()) {
+        Entry& entry = it->second;
+        if (entry.inLru) {
+            lru_.erase(entry.lruIt);
+            entry.inLru = false;
+        }
+
+        entry.references++;
+        return entry.handle;
+    }
+
+    Entry entry;
+    entry.handle = loader_->loadAsync(filepath, flipVertically, import);
+    entry.references = 1;
+
+    keysByTexture_[entry.handle.get()] = key;
+    auto result = entries_.emplace(key, entry);
+    return result.first->second.handle;
+}
+
+void TextureCache::release(TextureHandle& handle) {
+    if (!handle) return;
+
+    auto keyIt = keysByTexture_.find(handle.get());
+    handle.reset();
+
+    if (keyIt == keysByTexture_.end()) {
+        GAME_LOG_WARN("Released a texture that is not owned by the cache");
+        return;
+    }
+
+    auto it = entries_.find(keyIt->second);
+    Entry& entry = it->second;
+    if (--entry.references > 0) return;
+
+    entry.references = 0;
+    if (entry.handle->state.load() == TextureState::FAILED) {
+        evict(it);
+        return;
+    }
+
+    lru_.push_front(keyIt->second);
+    entry.lruIt = lru_.begin();
+    entry.inLru = true;
+
+    trim();
+}
+
+void TextureCache::setBudget(size_t budgetBytes) {
+    budgetBytes_ = budgetBytes;
+    trim();
+}
+
+size_t TextureCache::getResidentBytes() const {
+    size_t total = 0;
+    for (const auto& pair : entries_) {
+        total += getTextureBytes(*pair.second.handle);
+    }
+    return total;
+}
+
+void TextureCache::trim() {
+    size_t resident = getResidentBytes();
+
+    while (resident > budgetBytes_ && !lru_.empty()) {
+        std::string key = lru_.back();
+        lru_.pop_back();
+
+        auto it = entries_.find(key);
+        if (it == entries_.end()) continue;
+
+        size_t bytes = getTextureBytes(*it->second.handle);
+        resident -= bytes;
+
+        GAME_LOG_DEBUG("Evicting cached texture: " + it->second.handle->path + " (" + Utils::formatMemorySize(bytes) + ")");
+
+        it->second.inLru = false;
+        evict(it);
+    }
+}
+
+void TextureCache::evict(EntryMap::iterator it) {
+    Entry& entry = it->second;
+    if (entry.inLru) {
+        lru_.erase(entry.lruIt);
+    }
+
+    keysByTexture_.erase(entry.handle.get());
+    loader_->unload(entry.handle);
+    entries_.erase(it);
+}
+
+void TextureCache::clear() {
+    for (auto& pair : entries_) {
+        if (pair.second.references > 0) {
+            GAME_LOG_WARN("Texture still referenced while clearing cache: " + pair.second.handle->path);
+        }
+        loader_->unload(pair.second.handle);
+    }
+
+    entries_.clear();
+    keysByTexture_.clear();
+    lru_.clear();
+}
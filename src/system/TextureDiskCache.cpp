@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "system/TextureDiskCache.h"
+#include "system/Logger.h"
+#include "utils/Utils.h"
+
+static std::vector<unsigned char> downsample(const unsigned char* src, int width, int height, int channels,
+                                             int& outWidth, int& outHeight) {
+    outWidth = std::max(width / 2, 1);
+    outHeight = std::max(height / 2, 1);
+
+    std::vector<unsigned char> dst((size_t)outWidth * outHeight * channels);
+
+    for (int y = 0; y < outHeight; ++y) {
+        int y0 = std::min(y * 2, height - 1);
+        int y1 = std::min(y * 2 + 1, height - 1);
+
+        for (int x = 0; x < outWidth; ++x) {
+            int x0 = std::min(x * 2, width - 1);
+            int x1 = std::min(x * 2 + 1, width - 1);
+
+            const unsigned char* a = src + ((size_t)y0 * width + x0) * channels;
+            const unsigned char* b = src + ((size_t)y0 * width + x1) * channels;
+            const unsigned char* c = src + ((size_t)y1 * width + x0) * channels;
+            const unsigned char* d = src + ((size_t)y1 * width + x1) * channels;
+            unsigned char* out = dst.data() + ((size_t)y * outWidth + x) * channels;
+
+            for (int i = 0; i < channels; ++i) {
+                out[i] = (unsigned char)((a[i] + b[i] + c[i] + d[i] + 2) / 4);
+            }
+        }
+    }
+
+    return dst;
+}
+
+size_t CachedTexture::getTotalSize() const {
+    size_t total = 0;
+    for (const auto& level : levels) {
+        total += level.size;
+    }
+    return total;
+}
+
+TextureDiskCache::TextureDiskCache(const std::string& directory)
+    : directory_(directory) {
+    try {
+        std::filesystem::create_directories(directory_);
+        available_ = true;
+    } catch (const std::exception& e) {
+        GAME_LOG_WARN("Texture disk cache disabled, cannot create " + directory_ + ": " + e.what());
+    }
+}
+
+std::string TextureDiskCache::getCachePath(const std::string& sourcePath, bool flipVertically,
+                                           const TextureImportOptions& import) const {
+    std::string key = sourcePath + (flipVertically ? "|flip" : "|noflip") + import.getKey();
+    return directory_ + "/" + Utils::toHex(Utils::hashBytes(key.data(), key.size())) + ".atxc";
+}
+
+bool TextureDiskCache::getSourceInfo(const std::string& sourcePath, SourceInfo& info) {
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(sourcePath, ec);
+    if (ec) return false;
+
+    auto size = std::filesystem::file_size(sourcePath, ec);
+    if (ec) return false;
+
+    info.mtime = (uint64_t)mtime.time_since_epoch().count();
+    info.size = (uint64_t)size;
+    return true;
+}
+
+bool TextureDiskCache::hashSourceFile(const std::string& sourcePath, uint64_t& hash) {
+    MappedFile source;
+    if (!source.open(sourcePath)) return false;
+
+    hash = Utils::hashBytes(source.data(), source.size());
+    return true;
+}
+
+std::unique_ptr<CachedTexture> TextureDiskCache::load(const std::string& sourcePath, bool flipVertically,
+                                                      const TextureImportOptions& import) {
+    if (!available_) return nullptr;
+
+    SourceInfo info;
+    if (!getSourceInfo(sourcePath, info)) return nullptr;
+
+    std::string cachePath = getCachePath(sourcePath, flipVertically, import);
+
+    auto cached = std::make_unique<CachedTexture>();
+    if (!cached->file.open(cachePath)) return nullptr;
+
+    const unsigned char* base = cached->file.data();
+    size_t fileSize = cached->file.size();
+
+    if (fileSize < sizeof(TextureCacheHeader)) return nullptr;
+
+    TextureCacheHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    if (header.magic != TEXTURE_CACHE_MAGIC || header.version != TEXTURE_CACHE_VERSION ||
+        header.flipped != (flipVertically ? 1u : 0u) || header.mipCount == 0 ||
+        header.channels == 0 || header.channels > 4 || header.sourceSize != info.size) {
+        return nullptr;
+    }
+
+    // A touched but unchanged source only costs a hash, not a decode.
+    if (header.sourceMtime != info.mtime) {
+        uint64_t hash;
+        if (!hashSourceFile(sourcePath, hash) || hash != header.contentHash) {
+            return nullptr;
+        }
+    }
+
+    size_t tableEnd = sizeof(TextureCacheHeader) + (size_t)header.mipCount * sizeof(TextureCacheLevel);
+    if (fileSize < tableEnd) return nullptr;
+
+    for (uint32_t i = 0; i < header.mipCount; ++i) {
+        TextureCacheLevel level;
+        std::memcpy(&level, base + sizeof(TextureCacheHeader) + i * sizeof(TextureCacheLevel), sizeof(level));
+
+        if (level.offset + level.size > fileSize || level.size != (uint64_t)level.width * level.height * header.channels) {
+            GAME_LOG_WARN("Corrupt texture cache entry: " + cachePath);
+            return nullptr;
+        }
+
+        cached->levels.push_back({ base + level.offset, (size_t)level.size, (int)level.width, (int)level.height });
+    }
+
+    cached->width = (int)header.width;
+    cached->height = (int)header.height;
+    cached->channels = (int)header.channels;
+    return cached;
+}
+
+bool TextureDiskCache::store(const std::string& sourcePath, bool flipVertically, const TextureImportOptions& import,
+                             const unsigned char* pixels, int width, int height, int channels) {
+    if (!available_ || !pixels || width <= 0 || height <= 0 || channels < 1 || channels > 4) return false;
+
+    SourceInfo info;
+    uint64_t contentHash;
+    if (!getSourceInfo(sourcePath, info) || !hashSourceFile(sourcePath, contentHash)) return false;
+
+    std::vector<std::vector<unsigned char>> mips;
+    std::vector<TextureCacheLevel> levels;
+
+    int levelWidth = width;
+    int levelHeight = height;
+    const unsigned char* levelData = pixels;
+
+    while (true) {
+        levels.push_back({ 0, (uint64_t)levelWidth * levelHeight * channels, (uint32_t)levelWidth, (uint32_t)levelHeight });
+        if (!import.mipmaps || (levelWidth == 1 && levelHeight == 1)) break;
+
+        int nextWidth, nextHeight;
+        mips.push_back(downsample(levelData, levelWidth, levelHeight, channels, nextWidth, nextHeight));
+        levelData = mips.back().data();
+        levelWidth = nextWidth;
+        levelHeight = nextHeight;
+    }
+
+    uint64_t offset = sizeof(TextureCacheHeader) + levels.size() * sizeof(TextureCacheLevel);
+    for (auto& level : levels) {
+        level.offset = offset;
+        offset += level.size;
+    }
+
+    TextureCacheHeader header = {};
+    header.magic = TEXTURE_CACHE_MAGIC;
+    header.version = TEXTURE_CACHE_VERSION;
+    header.sourceMtime = info.mtime;
+    header.sourceSize = info.size;
+    header.contentHash = contentHash;
+    header.width = (uint32_t)width;
+    header.height = (uint32_t)height;
+    header.mipCount = (uint32_t)levels.size();
+    header.flipped = flipVertically ? 1u : 0u;
+    header.channels = (uint32_t)channels;
+
+    std::string cachePath = getCachePath(sourcePath, flipVertically, import);
+    std::string tempPath = cachePath + ".tmp";
+
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            GAME_LOG_WARN("Failed to write texture cache: " + tempPath);
+            return false;
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(levels.data()), levels.size() * sizeof(TextureCacheLevel));
+        out.write(reinterpret_cast<const char*>(pixels), (std::streamsize)levels[0].size);
+        for (size_t i = 0; i < mips.size(); ++i) {
+            out.write(reinterpret_cast<const char*>(mips[i].data()), (std::streamsize)mips[i].size());
+        }
+
+        if (!out.good()) {
+            out.close();
+            GAME_LOG_WARN("Failed to write texture cache: " + tempPath);
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    // Rename last so a concurrent reader never maps a half-written file.
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+    GAME_LOG_DEBUG("Cached decoded texture: " + sourcePath + " -> " + cachePath);
+    return true;
+}
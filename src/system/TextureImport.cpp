@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "system/TextureImport.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TEXTURE_IMPORT_USE_SSE 1
+#endif
+
+std::string TextureImportOptions::getKey() const {
+    if (maxWidth <= 0 && maxHeight <= 0 && mipmaps) return "";
+
+    return std::to_string(maxWidth) + "x" + std::to_string(maxHeight) +
+           (fit == TextureFit::COVER ? "c" : "f") + (mipmaps ? "m" : "");
+}
+
+namespace TextureImport
+{
+    namespace {
+        // Source pixels covering each destination pixel along one axis:
+        // first index, count, and normalized weights starting at offset.
+        struct Span {
+            int first;
+            int count;
+            size_t offset;
+        };
+
+        void buildSpans(int srcSize, int dstSize, std::vector<Span>& spans, std::vector<float>& weights) {
+            double scale = (double)srcSize / dstSize;
+            spans.resize(dstSize);
+            weights.clear();
+
+            for (int i = 0; i < dstSize; ++i) {
+                double start = i * scale;
+                double end = std::min((i + 1) * scale, (double)srcSize);
+
+                int first = (int)start;
+                int last = std::min((int)std::ceil(end) - 1, srcSize - 1);
+
+                spans[i] = { first, last - first + 1, weights.size() };
+                for (int s = first; s <= last; ++s) {
+                    double coverage = std::min(end, s + 1.0) - std::max(start, (double)s);
+                    weights.push_back((float)(coverage / (end - start)));
+                }
+            }
+        }
+
+        // acc[i] += src[i] * weight, the bulk of the work.
+        void accumulateRow(float* acc, const unsigned char* src, size_t count, float weight) {
+            size_t i = 0;
+
+#ifdef TEXTURE_IMPORT_USE_SSE
+            __m128 weight4 = _mm_set1_ps(weight);
+            __m128i zero = _mm_setzero_si128();
+
+            for (; i + 16 <= count; i += 16) {
+                __m128i bytes = _mm_loadu_si128((const __m128i*)(src + i));
+                __m128i low = _mm_unpacklo_epi8(bytes, zero);
+                __m128i high = _mm_unpackhi_epi8(bytes, zero);
+
+                __m128 f0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero));
+                __m128 f1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero));
+                __m128 f2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero));
+                __m128 f3 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero));
+
+                _mm_storeu_ps(acc + i,      _mm_add_ps(_mm_loadu_ps(acc + i),      _mm_mul_ps(f0, weight4)));
+                _mm_storeu_ps(acc + i + 4,  _mm_add_ps(_mm_loadu_ps(acc + i + 4),  _mm_mul_ps(f1, weight4)));
+                _mm_storeu_ps(acc + i + 8,  _mm_add_ps(_mm_loadu_ps(acc + i + 8),  _mm_mul_ps(f2, weight4)));
+                _mm_storeu_ps(acc + i + 12, _mm_add_ps(_mm_loadu_ps(acc + i + 12), _mm_mul_ps(f3, weight4)));
+            }
+#endif
+
+            for (; i < count; ++i) {
+                acc[i] += src[i] * weight;
+            }
+        }
+
+        void resampleRow(const float* acc, unsigned char* dst, const std::vector<Span>& spans,
+                         const std::vector<float>& weights, int channels) {
+            int dstWidth = (int)spans.size();
+
+#ifdef TEXTURE_IMPORT_USE_SSE
+            // One pixel per vector. RGB loads read a float past the pixel,
+            // which the row padding keeps in bounds; it is never stored.
+            if (channels == 3 || channels == 4) {
+                for (int x = 0; x < dstWidth; ++x) {
+                    const Span& span = spans[x];
+                    const float* w = weights.data() + span.offset;
+                    const float* p = acc + (size_t)span.first * channels;
+
+                    __m128 sum = _mm_setzero_ps();
+                    for (int k = 0; k < span.count; ++k) {
+                        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(p + k * channels), _mm_set1_ps(w[k])));
+                    }
+
+                    // Round, then saturate down to bytes.
+                    __m128i ints = _mm_cvtps_epi32(sum);
+                    __m128i shorts = _mm_packs_epi32(ints, ints);
+                    __m128i bytes = _mm_packus_epi16(shorts, shorts);
+                    int packed = _mm_cvtsi128_si32(bytes);
+                    std::memcpy(dst + (size_t)x * channels, &packed, channels);
+                }
+                return;
+            }
+#endif
+
+            for (int x = 0; x < dstWidth; ++x) {
+                const Span& span = spans[x];
+                const float* w = weights.data() + span.offset;
+
+                for (int c = 0; c < channels; ++c) {
+                    const float* p = acc + (size_t)span.first * channels + c;
+                    float sum = 0.0f;
+                    for (int k = 0; k < span.count; ++k) {
+                        sum += p[(size_t)k * channels] * w[k];
+                    }
+                    dst[(size_t)x * channels + c] = (unsigned char)std::clamp((int)std::lround(sum), 0, 255);
+                }
+            }
+        }
+    }
+
+    void getImportSize(int width, int height, const TextureImportOptions& options, int& outWidth, int& outHeight) {
+        outWidth = width;
+        outHeight = height;
+        if (width <= 0 || height <= 0) return;
+
+        double scaleX = options.maxWidth > 0 ? (double)options.maxWidth / width : 0.0;
+        double scaleY = options.maxHeight > 0 ? (double)options.maxHeight / height : 0.0;
+
+        double scale;
+        if (scaleX > 0.0 && scaleY > 0.0) {
+            scale = options.fit == TextureFit::COVER ? std::max(scaleX, scaleY) : std::min(scaleX, scaleY);
+        } else {
+            scale = std::max(scaleX, scaleY);
+        }
+
+        if (scale <= 0.0 || scale >= 1.0) return;
+
+        outWidth = std::max((int)std::lround(width * scale), 1);
+        outHeight = std::max((int)std::lround(height * scale), 1);
+    }
+
+    void resize(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst, int dstWidth, int dstHeight,
+                int channels) {
+        std::vector<Span> columns, rows;
+        std::vector<float> columnWeights, rowWeights;
+        buildSpans(srcWidth, dstWidth, columns, columnWeights);
+        buildSpans(srcHeight, dstHeight, rows, rowWeights);
+
+        size_t srcStride = (size_t)srcWidth * channels;
+        size_t dstStride = (size_t)dstWidth * channels;
+        std::vector<float> acc(srcStride + 4);
+
+        // Vertical pass into one float row, then horizontal pass out of it.
+        for (int y = 0; y < dstHeight; ++y) {
+            const Span& span = rows[y];
+            std::fill(acc.begin(), acc.begin() + srcStride, 0.0f);
+
+            for (int k = 0; k < span.count; ++k) {
+                accumulateRow(acc.data(), src + (size_t)(span.first + k) * srcStride, srcStride,
+                              rowWeights[span.offset + k]);
+            }
+
+            resampleRow(acc.data(), dst + (size_t)y * dstStride, columns, columnWeights, channels);
+        }
+    }
+}
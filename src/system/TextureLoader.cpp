@@ -0,0 +1,384 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "system/TextureLoader.h"
+#include "system/GLState.h"
+#include "system/Logger.h"
+
+#include <stb_image.h>
+
+float AsyncTexture::getFadeProgress() const {
+    if (!isResident()) return 0.0f;
+    if (fadeDuration <= 0.0f) return 1.0f;
+
+    return std::min(fadeElapsed / fadeDuration, 1.0f);
+}
+
+TextureLoader::TextureLoader(Renderer2D* renderer, int workerCount)
+    : renderer_(renderer) {
+    workerCount = std::max(workerCount, 1);
+    for (int i = 0; i < workerCount; ++i) {
+        workers_.emplace_back(&TextureLoader::workerLoop, this);
+    }
+}
+
+TextureLoader::~TextureLoader() {
+    shutdown();
+}
+
+void TextureLoader::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (!running_ && workers_.empty()) return;
+        running_ = false;
+    }
+    cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+
+    for (auto& handle : uploadQueue_) {
+        releasePixels(*handle);
+    }
+    decodeQueue_.clear();
+    uploadQueue_.clear();
+    fading_.clear();
+
+    if (uploadPBO_) {
+        GLState::getInstance().deleteBuffer(uploadPBO_);
+        uploadPBO_ = 0;
+        uploadPBOSize_ = 0;
+    }
+}
+
+TextureHandle TextureLoader::loadAsync(const std::string& filepath, bool flipVertically,
+                                       const TextureImportOptions& import) {
+    auto handle = std::make_shared<AsyncTexture>();
+    handle->path = filepath;
+    handle->flipVertically = flipVertically;
+    handle->import = import;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        decodeQueue_.push_back(handle);
+    }
+    cv_.notify_one();
+
+    return handle;
+}
+
+void TextureLoader::unload(TextureHandle& handle) {
+    if (!handle) return;
+
+    TextureState expected = TextureState::PENDING;
+    if (!handle->state.compare_exchange_strong(expected, TextureState::CANCELLED)) {
+        expected = TextureState::DECODED;
+        handle->state.compare_exchange_strong(expected, TextureState::CANCELLED);
+    }
+
+    if (handle->textureID) {
+        // Goes through the renderer so a pending batch using it is flushed.
+        renderer_->unloadTexture(handle->textureID);
+        handle->textureID = 0;
+    }
+
+    handle.reset();
+}
+
+size_t TextureLoader::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    return decodeQueue_.size() + decodingCount_ + uploadQueue_.size();
+}
+
+void TextureLoader::workerLoop() {
+    while (true) {
+        TextureHandle handle;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            cv_.wait(lock, [this] { return !running_ || !decodeQueue_.empty(); });
+
+            if (!running_) return;
+
+            handle = decodeQueue_.front();
+            decodeQueue_.pop_front();
+            decodingCount_++;
+        }
+
+        bool decoded = false;
+        if (handle->state.load() != TextureState::CANCELLED) {
+            if (!decodeTexture(*handle)) {
+                GAME_LOG_ERROR("Failed to load texture: " + handle->path);
+                handle->state.store(TextureState::FAILED);
+            } else {
+                TextureState expected = TextureState::PENDING;
+                decoded = handle->state.compare_exchange_strong(expected, TextureState::DECODED);
+                if (!decoded) {
+                    releasePixels(*handle);
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        decodingCount_--;
+        if (decoded) {
+            uploadQueue_.push_back(handle);
+        }
+    }
+}
+
+bool TextureLoader::decodeTexture(AsyncTexture& texture) {
+    if (diskCache_) {
+        texture.cached = diskCache_->load(texture.path, texture.flipVertically, texture.import);
+        if (texture.cached) {
+            texture.width = texture.cached->width;
+            texture.height = texture.cached->height;
+            texture.channels = texture.cached->channels;
+            return true;
+        }
+    }
+
+    // The global flip flag is shared with Renderer2D::loadTexture on the
+    // main thread, so only ever touch the per-thread one here.
+    stbi_set_flip_vertically_on_load_thread(texture.flipVertically);
+
+    // Grey and grey-alpha images are expanded so they never upload as red
+    // R8/RG8, with or without the disk cache. Opaque images stay RGB: the
+    // driver pads RGB8 texels to 4 bytes anyway, but the disk cache entry
+    // and the PBO upload are a quarter smaller than RGBA.
+    int width, height, channels;
+    int desiredChannels = 4;
+    if (stbi_info(texture.path.c_str(), &width, &height, &channels)) {
+        desiredChannels = (channels == 2 || channels == 4) ? 4 : 3;
+    }
+
+    unsigned char* data = stbi_load(texture.path.c_str(), &width, &height, &channels, desiredChannels);
+
+    if (!data) {
+        return false;
+    }
+
+    channels = desiredChannels;
+
+    int importWidth, importHeight;
+    TextureImport::getImportSize(width, height, texture.import, importWidth, importHeight);
+
+    const unsigned char* pixels = data;
+    if (importWidth != width || importHeight != height) {
+        texture.resizedPixels.resize((size_t)importWidth * importHeight * channels);
+        TextureImport::resize(data, width, height, texture.resizedPixels.data(), importWidth, importHeight, channels);
+        stbi_image_free(data);
+        data = nullptr;
+
+        GAME_LOG_DEBUG("Downscaled texture on import: " + texture.path + " (" + std::to_string(width) + "x" +
+                       std::to_string(height) + " -> " + std::to_string(importWidth) + "x" +
+                       std::to_string(importHeight) + ")");
+
+        pixels = texture.resizedPixels.data();
+        width = importWidth;
+        height = importHeight;
+    }
+
+    texture.width = width;
+    texture.height = height;
+    texture.channels = channels;
+
+    if (diskCache_ &&
+        diskCache_->store(texture.path, texture.flipVertically, texture.import, pixels, width, height, channels)) {
+        texture.cached = diskCache_->load(texture.path, texture.flipVertically, texture.import);
+        if (texture.cached) {
+            if (data) {
+                stbi_image_free(data);
+            }
+            texture.resizedPixels.clear();
+            texture.resizedPixels.shrink_to_fit();
+            return true;
+        }
+    }
+
+    texture.pixels = data ? data : texture.resizedPixels.data();
+    return true;
+}
+
+void TextureLoader::releasePixels(AsyncTexture& texture) {
+    if (!texture.resizedPixels.empty()) {
+        texture.resizedPixels.clear();
+        texture.resizedPixels.shrink_to_fit();
+        texture.pixels = nullptr;
+    } else if (texture.pixels) {
+        stbi_image_free(texture.pixels);
+        texture.pixels = nullptr;
+    }
+    texture.cached.reset();
+}
+
+void TextureLoader::update(float deltaTime) {
+    float step = std::min(deltaTime, TEXTURE_FADE_MAX_STEP);
+
+    for (auto& entry : fading_) {
+        if (TextureHandle handle = entry.lock()) {
+            handle->fadeElapsed += step;
+        }
+    }
+
+    fading_.erase(std::remove_if(fading_.begin(), fading_.end(), [](const std::weak_ptr<AsyncTexture>& entry) {
+        TextureHandle handle = entry.lock();
+        return !handle || !handle->textureID || handle->fadeElapsed >= handle->fadeDuration;
+    }), fading_.end());
+}
+
+void TextureLoader::processUploads(double budgetMs) {
+    auto start = std::chrono::steady_clock::now();
+
+    while (true) {
+        TextureHandle handle;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            if (uploadQueue_.empty()) return;
+
+            handle = uploadQueue_.front();
+            uploadQueue_.pop_front();
+        }
+
+        if (handle->state.load() == TextureState::DECODED) {
+            uploadTexture(*handle);
+            if (handle->isResident() && handle->fadeDuration > 0.0f) {
+                fading_.push_back(handle);
+            }
+        }
+
+        releasePixels(*handle);
+
+        double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (elapsedMs >= budgetMs) return;
+    }
+}
+
+void TextureLoader::uploadTexture(AsyncTexture& texture) {
+    GLState& gl = GLState::getInstance();
+
+    // Sized internal formats, so an RGB texture is not silently padded to
+    // RGBA by the driver.
+    GLenum format = GL_RGB;
+    GLenum internalFormat = GL_RGB8;
+    if (texture.channels == 1) {
+        format = GL_RED;
+        internalFormat = GL_R8;
+    } else if (texture.channels == 2) {
+        format = GL_RG;
+        internalFormat = GL_RG8;
+    } else if (texture.channels == 4) {
+        format = GL_RGBA;
+        internalFormat = GL_RGBA8;
+    }
+
+    // Either the single decoded image or the cached mip chain, uploaded
+    // back to back out of one PBO.
+    std::vector<CachedTexture::Level> levels;
+    if (texture.cached) {
+        levels = texture.cached->levels;
+    } else {
+        levels.push_back({ texture.pixels, (size_t)texture.width * texture.height * texture.channels,
+                           texture.width, texture.height });
+    }
+
+    size_t size = 0;
+    for (const auto& level : levels) {
+        size += level.size;
+    }
+
+    if (!uploadPBO_) {
+        glGenBuffers(1, &uploadPBO_);
+    }
+
+    gl.bindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadPBO_);
+    if (size > uploadPBOSize_) {
+        uploadPBOSize_ = size;
+    }
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, uploadPBOSize_, nullptr, GL_STREAM_DRAW);
+
+    unsigned char* dst = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!dst) {
+        gl.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        GAME_LOG_ERROR("Failed to map upload buffer for texture: " + texture.path);
+        texture.state.store(TextureState::FAILED);
+        return;
+    }
+
+    size_t offset = 0;
+    for (const auto& level : levels) {
+        std::memcpy(dst + offset, level.data, level.size);
+        offset += level.size;
+    }
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    gl.bindTexture(0, textureID);
+
+    // Without the disk cache there is only the base level; the driver
+    // builds the rest of the chain when the import wants one.
+    int mipCount = (int)levels.size();
+    bool generateMips = mipCount == 1 && texture.import.mipmaps && (texture.width > 1 || texture.height > 1);
+    if (generateMips) {
+        mipCount = (int)std::floor(std::log2((double)std::max(texture.width, texture.height))) + 1;
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipCount - 1);
+
+    // Rows are tightly packed; put the previous alignment back afterwards,
+    // other uploaders rely on the default.
+    GLint previousAlignment = 4;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    offset = 0;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        glTexImage2D(GL_TEXTURE_2D, (GLint)i, internalFormat, levels[i].width, levels[i].height, 0,
+                     format, GL_UNSIGNED_BYTE, (void*)offset);
+        offset += levels[i].size;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+
+    if (generateMips) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    // Leaving the PBO bound would turn every later client-memory upload
+    // into an offset into it.
+    gl.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    // Drivers pad RGB8 texels to 4 bytes, so count what is actually
+    // resident rather than what was uploaded.
+    size_t texelBytes = texture.channels == 3 ? 4 : (size_t)texture.channels;
+    size_t gpuBytes = 0;
+    int levelWidth = texture.width;
+    int levelHeight = texture.height;
+    for (int i = 0; i < mipCount; ++i) {
+        gpuBytes += (size_t)levelWidth * levelHeight * texelBytes;
+        levelWidth = std::max(levelWidth / 2, 1);
+        levelHeight = std::max(levelHeight / 2, 1);
+    }
+
+    texture.textureID = textureID;
+    texture.gpuBytes = gpuBytes;
+    texture.fadeElapsed = 0.0f;
+    if (!fadeEnabled_) {
+        texture.fadeDuration = 0.0f;
+    }
+    texture.state.store(TextureState::RESIDENT);
+
+    GAME_LOG_INFO("Loaded texture: " + texture.path + " (" + std::to_string(texture.width) + "x" +
+                  std::to_string(texture.height) + ", " + std::to_string(texture.channels) + " channels" +
+                  (texture.cached ? ", from disk cache)" : ")"));
+}
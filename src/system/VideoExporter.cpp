@@ -0,0 +1,176 @@
+#include <cstring>
+
+#include "system/VideoExporter.h"
+#include "system/GLState.h"
+#include "system/Logger.h"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+VideoExporter::~VideoExporter() {
+    close();
+}
+
+bool VideoExporter::open(const std::string& output, int width, int height) {
+    close();
+
+    isPipe_ = !output.empty() && output[0] == '|';
+    file_ = isPipe_ ? popen(output.c_str() + 1, "w") : fopen(output.c_str(), "wb");
+    if (!file_) {
+        GAME_LOG_ERROR("Failed to open video output: " + output);
+        return false;
+    }
+
+    width_ = width;
+    height_ = height;
+    frameSize_ = (size_t)width * height * 4;
+    nextReadback_ = 0;
+    capturedFrames_ = 0;
+    writeFailed_ = false;
+
+    for (Readback& readback : readbacks_) {
+        glGenBuffers(1, &readback.buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, frameSize_, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    writing_ = true;
+    writer_ = std::thread(&VideoExporter::writerLoop, this);
+
+    GAME_LOG_INFO("Exporting " + std::to_string(width) + "x" + std::to_string(height) + " RGBA frames to " + output);
+    return true;
+}
+
+void VideoExporter::capture(const RenderContext* target) {
+    if (!file_ || !target) return;
+
+    if (target->width != width_ || target->height != height_) {
+        GAME_LOG_ERROR("Export frame size changed, frame " + std::to_string(capturedFrames_) + " skipped");
+        return;
+    }
+
+    // The oldest readback was issued VIDEO_EXPORT_IN_FLIGHT - 1 frames ago
+    // and has almost always finished by now.
+    Readback& readback = readbacks_[nextReadback_];
+    retire(readback);
+
+    GLState& gl = GLState::getInstance();
+    GLuint previous = gl.getBoundFramebuffer();
+    gl.bindFramebuffer(target->framebuffer);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width_, height_, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    gl.bindFramebuffer(previous);
+
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    nextReadback_ = (nextReadback_ + 1) % VIDEO_EXPORT_IN_FLIGHT;
+    capturedFrames_++;
+}
+
+void VideoExporter::retire(Readback& readback) {
+    if (!readback.fence) return;
+
+    glClientWaitSync(readback.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    glDeleteSync(readback.fence);
+    readback.fence = nullptr;
+
+    std::vector<unsigned char> frame;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        queueChanged_.wait(lock, [this] { return queued_.size() < VIDEO_EXPORT_MAX_QUEUED; });
+
+        if (!spare_.empty()) {
+            frame = std::move(spare_.back());
+            spare_.pop_back();
+        }
+    }
+    frame.resize(frameSize_);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+    const unsigned char* pixels = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameSize_, GL_MAP_READ_BIT);
+
+    if (pixels) {
+        // GL rows are bottom-up.
+        size_t rowSize = (size_t)width_ * 4;
+        for (int y = 0; y < height_; ++y) {
+            std::memcpy(frame.data() + rowSize * y, pixels + rowSize * (height_ - 1 - y), rowSize);
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        GAME_LOG_ERROR("Failed to map export frame");
+        std::memset(frame.data(), 0, frameSize_);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued_.push_back(std::move(frame));
+    }
+    queueChanged_.notify_all();
+}
+
+void VideoExporter::close() {
+    if (!file_) return;
+
+    // Retire in capture order so frames stay in sequence.
+    for (int i = 0; i < VIDEO_EXPORT_IN_FLIGHT; ++i) {
+        retire(readbacks_[(nextReadback_ + i) % VIDEO_EXPORT_IN_FLIGHT]);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writing_ = false;
+    }
+    queueChanged_.notify_all();
+
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+
+    for (Readback& readback : readbacks_) {
+        glDeleteBuffers(1, &readback.buffer);
+        readback.buffer = 0;
+    }
+
+    int status = isPipe_ ? pclose(file_) : fclose(file_);
+    file_ = nullptr;
+
+    if (writeFailed_ || status != 0) {
+        GAME_LOG_ERROR("Video export failed after " + std::to_string(capturedFrames_) + " frames");
+    } else {
+        GAME_LOG_INFO("Exported " + std::to_string(capturedFrames_) + " frames");
+    }
+
+    queued_.clear();
+    spare_.clear();
+}
+
+void VideoExporter::writerLoop() {
+    while (true) {
+        std::vector<unsigned char> frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            queueChanged_.wait(lock, [this] { return !writing_ || !queued_.empty(); });
+
+            if (queued_.empty()) return;
+
+            frame = std::move(queued_.front());
+            queued_.pop_front();
+        }
+        queueChanged_.notify_all();
+
+        if (!writeFailed_ && fwrite(frame.data(), 1, frame.size(), file_) != frame.size()) {
+            GAME_LOG_ERROR("Failed to write export frame");
+            writeFailed_ = true;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        spare_.push_back(std::move(frame));
+    }
+}
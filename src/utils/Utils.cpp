@@ -1,6 +1,7 @@
 #define _USE_MATH_DEFINES
 
 #include <sstream>
+#include <iomanip>
 #include <filesystem>
 #include <algorithm>
 #include <iostream>
@@ -51,6 +52,26 @@ namespace Utils
         return oss.str();
     }
 
+    uint64_t hashBytes(const void *data, size_t size, uint64_t seed)
+    {
+        // 64-bit FNV-1a
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        uint64_t hash = seed;
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    std::string toHex(uint64_t value)
+    {
+        std::ostringstream oss;
+        oss << std::hex << std::setw(16) << std::setfill('0') << value;
+        return oss.str();
+    }
+
     bool fileExists(const std::string &path)
     {
 #ifdef _WIN32
@@ -110,7 +131,7 @@ namespace Utils
     bool loadWindowIcon(GLFWwindow* window, const std::string& iconPath) {
         int width, height, channels;
 
-        stbi_set_flip_vertically_on_load(false);
+        stbi_set_flip_vertically_on_load_thread(false);
         unsigned char* pixels = stbi_load(iconPath.c_str(), &width, &height, &channels, 4);
         
         if (!pixels) {